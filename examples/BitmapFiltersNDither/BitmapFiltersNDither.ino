@@ -20,6 +20,10 @@
  *     - BITMAP_FILTER::GRAY4           =>   The image will be converted to a 4 color (2 grays).
  *     - BITMAP_FILTER::DITHER_BW       =>   The image will be dithered with 2 colors (Black & White).
  *     - BITMAP_FILTER::DITHER_GRAY4    =>   The image will be dithered with 4 colors (Black & White & 2 Grays).
+ *     - BITMAP_FILTER::ORDERED_BW      =>   Ordered (Bayer) dither with 2 colors - no buffer, seamless when clipped.
+ *     - BITMAP_FILTER::ORDERED_BWR     =>   Ordered (Bayer) dither with Black & White & Red.
+ *     - BITMAP_FILTER::ORDERED_GRAY4   =>   Ordered (Bayer) dither with 4 colors (Black & White & 2 Grays).
+ *     - BITMAP_FILTER::DITHER_BWR      =>   Color error diffusion with Black & White & Red (tri-color panels).
  *     * For more information about dithering check the repo and the Dither example.
  * 
  * Filters can be automatically applied or "manually" adjusted check the repo readme for more information.
@@ -209,7 +213,13 @@ void setup() {
         // QUANTIZE:
         BitmapFilter_QUANT QUANT_filter;
         QUANT_filter.setColorMap(colormap, 3);
+        // QUANT_filter.setColorMetric(BITMAP_COLOR_METRIC::WEIGHTED); // perceptual (2:4:3) closest color
+        // static BITMAP_COLOR_LUT lut(4, 4, 3);  // 2KB closest color table - shared by the filters using this map (RAM cap: BITMAP_COLOR_LUT_MAX_RAM)
+        // lut.useSram(board);                      // optional - keep it at the top of the free SRAM (required on uno / nano / leonardo)
+        // QUANT_filter.setColorLUT(&lut);          // built now - each pixel is a single lookup
         EPD_BITMAP_STATUS drawQUANT = bitmap.drawBitmap(&QUANT_filter, 266, 0, board, 50, 60, 130, 147);
+        // Known filter type - the kernel is inlined in the row loops (no virtual calls per pixel):
+        // EPD_BITMAP_STATUS drawQUANT = bitmap.drawBitmap<BitmapFilter_QUANT>(&QUANT_filter, 266, 0, board, 50, 60, 130, 147);
 
         // GRAY4:
         uint16_t colormapGrays[5][4] = {
@@ -241,9 +251,32 @@ void setup() {
             {40,    40,     40,     EPD_WHITE   }
         };
         BitmapFilter_DITHER_GRAY4 DITHER_GRAY4_filter(0.85); // threshold 0.00 - 2.00
-        DITHER_GRAY4_filter.setWeightVector(DITHER_WEIGHTS_VECTOR_FLOYD); 
+        DITHER_GRAY4_filter.setWeightVector(DITHER_WEIGHTS_VECTOR_FLOYD);
+        // or a multi row kernel (replaces the weights vector):
+        //    - DITHER_KERNEL_JARVIS, DITHER_KERNEL_STUCKI, DITHER_KERNEL_BURKES, DITHER_KERNEL_SIERRA
+        //    - DITHER_KERNEL_SIERRA_TWO_ROW, DITHER_KERNEL_SIERRA_LITE, DITHER_KERNEL_ATKINSON
+        // DITHER_GRAY4_filter.setKernel(&DITHER_KERNEL_STUCKI);
+        // DITHER_GRAY4_filter.setSerpentine(true);  // odd rows right to left
+        // DITHER_GRAY4_filter.setStripWidth(64);    // dither in 64px strips - smaller error buffer
+        // DITHER_GRAY4_filter.setCompactErrors(true); // int8 error rows - when the levels range permits (threshold <= 1)
         DITHER_GRAY4_filter.setColorMap(colormap4gray, 5);
         EPD_BITMAP_STATUS drawDITHER_GRAY4 = bitmap.drawBitmapDithered(&DITHER_GRAY4_filter, 266, 150, board, 50, 60, 130, 147);
+
+        // ORDERED GRAY4 - a normal filter (drawBitmap):
+        BitmapFilter_ORDERED ORDERED_filter(BITMAP_ORDERED_MASK::BLUE_NOISE_16X16, 34); // mask, spread 0 - 100 (100 for BW / BWR)
+        // masks: BAYER_4X4, BAYER_8X8, BLUE_NOISE_16X16
+        ORDERED_filter.setColorMap(colormapGrays, 4);
+        EPD_BITMAP_STATUS drawORDERED_GRAY4 = bitmap.drawBitmap(&ORDERED_filter, 0, 0, board, 50, 60, 130, 147);
+
+        // DITHER BWR - color error diffusion to the panel palette (drawBitmapDithered):
+        uint16_t colormapBWR[3][4] = {
+            { 0,     0,      0,  EPD_BLACK },
+            { 31,    63,     31, EPD_WHITE },
+            { 31,    0,      0,  EPD_RED   }
+        };
+        BitmapFilter_DITHER_BWR DITHER_BWR_filter(1); // brightness 0.00 - 2.00
+        DITHER_BWR_filter.setColorMap(colormapBWR, 3);
+        EPD_BITMAP_STATUS drawDITHER_BWR = bitmap.drawBitmapDithered(&DITHER_BWR_filter, 133, 0, board, 50, 60, 130, 147);
     */
 }
 
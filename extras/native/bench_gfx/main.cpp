@@ -0,0 +1,213 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * GFX primitives microbenchmark:
+ *  Runs a fixed workload per primitive (pixels, lines, rects, circles, text
+ *  and fillScreen) on every driver (G4, 3CU, 3CS) in RAM and SRAM framebuffer
+ *  modes and rotations 0 - 3. The SPI / SRAM layer is the native mock.
+ * Per workload (JSON):
+ *  calls               - primitive calls of the workload.
+ *  pixels              - pixels the workload covers - counted by replaying it
+ *                        on a counting Adafruit_GFX surface.
+ *  host_ns             - best host wall time of the repeats.
+ *  ns_per_pixel        - host_ns / pixels.
+ *  sram_transactions   - SRAM transactions of the workload (0 in RAM mode).
+ *  sram_tx_per_call    - SRAM transactions per primitive call.
+ *  sim_us              - simulated bus time of the workload.
+ * Usage:
+ *  pio run -e native_bench_gfx
+ *  .pio/build/native_bench_gfx/program [repeats] > gfx.json
+*******************************************************************************/
+
+#include <SIKTEC_EPD_NATIVE.h>
+
+using namespace SIKtec;
+
+#ifndef NATIVE_BENCH_REPEATS
+    #define NATIVE_BENCH_REPEATS 3 // host timing repeats per workload - the best is reported
+#endif
+
+/**
+ * @brief counts the pixels a workload sets - the primitives decompose as on the boards.
+ */
+class NativePixelCounter : public Adafruit_GFX {
+public:
+    uint32_t pixels = 0;
+    NativePixelCounter(int16_t w, int16_t h) : Adafruit_GFX(w, h) {}
+    void drawPixel(int16_t x, int16_t y, uint16_t color) {
+        (void)color;
+        if (x >= 0 && y >= 0 && x < this->width() && y < this->height()) {
+            this->pixels++;
+        }
+    }
+};
+
+/**
+ * @brief a workload - draws on the surface and returns the number of primitive calls.
+ */
+typedef uint32_t (*native_workload_t)(Adafruit_GFX *gfx);
+
+static uint32_t workloadPixel(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    for (int16_t y = 0; y < gfx->height(); y++) {
+        for (int16_t x = 0; x < gfx->width(); x++, calls++) {
+            gfx->drawPixel(x, y, (x ^ y) & 1 ? EPD_BLACK : EPD_WHITE);
+        }
+    }
+    return calls;
+}
+
+static uint32_t workloadHLine(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    for (int16_t y = 0; y < gfx->height(); y++, calls++) {
+        gfx->drawFastHLine(0, y, gfx->width(), y & 1 ? EPD_BLACK : EPD_WHITE);
+    }
+    return calls;
+}
+
+static uint32_t workloadVLine(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    for (int16_t x = 0; x < gfx->width(); x++, calls++) {
+        gfx->drawFastVLine(x, 0, gfx->height(), x & 1 ? EPD_BLACK : EPD_WHITE);
+    }
+    return calls;
+}
+
+static uint32_t workloadLine(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    int16_t w = gfx->width(), h = gfx->height();
+    //A fan from each corner:
+    for (int16_t i = 0; i < 32; i++, calls += 2) {
+        gfx->drawLine(0, 0, w - 1, (int32_t)i * (h - 1) / 31, EPD_BLACK);
+        gfx->drawLine(w - 1, h - 1, (int32_t)i * (w - 1) / 31, 0, EPD_BLACK);
+    }
+    return calls;
+}
+
+static uint32_t workloadRect(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    for (int16_t i = 0; i * 2 < gfx->height(); i += 4, calls++) {
+        gfx->drawRect(i, i, gfx->width() - i * 2, gfx->height() - i * 2, EPD_BLACK);
+    }
+    return calls;
+}
+
+static uint32_t workloadFillRect(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    int16_t w = gfx->width() / 4, h = gfx->height() / 4;
+    for (int16_t y = 0; y < 4; y++) {
+        for (int16_t x = 0; x < 4; x++, calls++) {
+            gfx->fillRect(x * w + 1, y * h + 1, w - 2, h - 2, (x ^ y) & 1 ? EPD_BLACK : EPD_WHITE);
+        }
+    }
+    return calls;
+}
+
+static uint32_t workloadCircle(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    int16_t cx = gfx->width() / 2, cy = gfx->height() / 2;
+    for (int16_t r = 4; r < min(cx, cy); r += 6, calls++) {
+        gfx->drawCircle(cx, cy, r, EPD_BLACK);
+    }
+    return calls;
+}
+
+static uint32_t workloadFillCircle(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    int16_t r = min(gfx->width(), gfx->height()) / 8;
+    for (int16_t y = r; y + r < gfx->height(); y += r * 2) {
+        for (int16_t x = r; x + r < gfx->width(); x += r * 2, calls++) {
+            gfx->fillCircle(x, y, r - 1, EPD_BLACK);
+        }
+    }
+    return calls;
+}
+
+static uint32_t workloadText(Adafruit_GFX *gfx) {
+    uint32_t calls = 0;
+    gfx->setTextWrap(true);
+    gfx->setTextColor(EPD_BLACK);
+    for (uint8_t size = 1; size <= 2; size++) {
+        gfx->setTextSize(size);
+        gfx->setCursor(0, size == 1 ? 0 : gfx->height() / 2);
+        for (uint8_t c = 0; c < 160; c++, calls++) {
+            gfx->write((uint8_t)('!' + c % 90));
+        }
+    }
+    return calls;
+}
+
+static uint32_t workloadFillScreen(Adafruit_GFX *gfx) {
+    gfx->fillScreen(EPD_BLACK);
+    return 1;
+}
+
+static const struct {
+    const char          *name;
+    native_workload_t   run;
+} workloads[] = {
+    { "drawPixel",      workloadPixel       },
+    { "drawFastHLine",  workloadHLine       },
+    { "drawFastVLine",  workloadVLine       },
+    { "drawLine",       workloadLine        },
+    { "drawRect",       workloadRect        },
+    { "fillRect",       workloadFillRect    },
+    { "drawCircle",     workloadCircle      },
+    { "fillCircle",     workloadFillCircle  },
+    { "text",           workloadText        },
+    { "fillScreen",     workloadFillScreen  },
+};
+
+int main(int argc, char **argv) {
+
+    int repeats = argc > 1 ? atoi(argv[1]) : NATIVE_BENCH_REPEATS;
+    if (repeats < 1) {
+        fprintf(stderr, "usage: %s [repeats]\n", argv[0]);
+        return 1;
+    }
+
+    printf("{\n  \"benchmark\": \"gfx\",\n  \"repeats\": %d,\n  \"results\": [", repeats);
+    bool first = true;
+    for (uint8_t driver = 0; driver < NATIVE_DRIVERS; driver++) {
+        for (uint8_t sram = 0; sram < 2; sram++) {
+            SIKTEC_EPD *epd = nativeCreateBoard(driver, sram);
+            for (uint8_t rotation = 0; rotation < 4; rotation++) {
+                epd->setRotation(rotation);
+                for (size_t w = 0; w < sizeof(workloads) / sizeof(workloads[0]); w++) {
+                    NativePixelCounter counter(epd->width(), epd->height());
+                    workloads[w].run(&counter);
+                    uint32_t       calls = 0;
+                    uint64_t       best  = 0;
+                    native_stats_t stats;
+                    for (int r = 0; r < repeats; r++) {
+                        epd->clearBuffer();
+                        nativeResetStats();
+                        uint64_t start = nativeHostNanos();
+                        calls = workloads[w].run(epd);
+                        uint64_t took = nativeHostNanos() - start;
+                        stats = native_stats;
+                        if (r == 0 || took < best) best = took;
+                    }
+                    printf("%s\n    {\"driver\": \"%s\", \"mode\": \"%s\", \"rotation\": %u, \"primitive\": \"%s\", "
+                           "\"calls\": %lu, \"pixels\": %lu, \"host_ns\": %llu, \"ns_per_pixel\": %.2f, "
+                           "\"sram_transactions\": %llu, \"sram_tx_per_call\": %.2f, \"sim_us\": %llu, \"crc\": \"%016llx\"}",
+                        first ? "" : ",",
+                        native_driver_names[driver], sram ? "SRAM" : "RAM", (unsigned)rotation, workloads[w].name,
+                        (unsigned long)calls, (unsigned long)counter.pixels,
+                        (unsigned long long)best, counter.pixels ? (double)best / counter.pixels : 0.0,
+                        (unsigned long long)stats.sram_transactions, calls ? (double)stats.sram_transactions / calls : 0.0,
+                        (unsigned long long)stats.sim_micros, (unsigned long long)nativePlanesChecksum(epd)
+                    );
+                    first = false;
+                }
+            }
+            epd->setRotation(0);
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
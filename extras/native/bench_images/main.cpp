@@ -0,0 +1,102 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Image pipeline benchmark:
+ *  Decodes and draws every bitmap of a host directory with every builtin
+ *  BITMAP_FILTER (DITHER_BW / DITHER_GRAY4 / DITHER_BWR run drawBitmapDithered) in RAM
+ *  and SRAM framebuffer modes, and prints the results as JSON.
+ * Per draw:
+ *  host_ns             - best host wall time of the repeats (the CPU cost).
+ *  host_pixels_per_s   - drawn pixels / host time.
+ *  sim_us              - simulated bus time of the mocks (SD, SRAM and SPI).
+ *  sim_pixels_per_s    - drawn pixels / simulated time (the board I/O bound).
+ *  sd_bytes, sd_reads, sd_seeks, sd_opens, spi_transactions,
+ *  sram_transactions   - the mock counters of a single draw.
+ *  crc                 - framebuffer checksum - equal across releases unless
+ *                        the output changed.
+ * Usage:
+ *  pio run -e native_bench_images
+ *  .pio/build/native_bench_images/program [images dir] [G4|3CU|3CS] [repeats] > bench.json
+*******************************************************************************/
+
+#include <SIKTEC_EPD_NATIVE.h>
+
+using namespace SIKtec;
+
+#ifndef NATIVE_BENCH_REPEATS
+    #define NATIVE_BENCH_REPEATS 3 // host timing repeats per draw - the best is reported
+#endif
+
+int main(int argc, char **argv) {
+
+    const char *dir     = argc > 1 ? argv[1] : "extras/test_images";
+    int8_t      driver  = argc > 2 ? nativeDriverIndex(argv[2]) : 0;
+    int         repeats = argc > 3 ? atoi(argv[3]) : NATIVE_BENCH_REPEATS;
+    if (driver < 0 || repeats < 1) {
+        fprintf(stderr, "usage: %s [images dir] [G4|3CU|3CS] [repeats]\n", argv[0]);
+        return 1;
+    }
+
+    SdFat sd;
+    sd.begin(dir);
+    std::vector<std::string> images = nativeListBitmaps(dir);
+    if (images.empty()) {
+        fprintf(stderr, "No bitmaps found in %s\n", dir);
+        return 1;
+    }
+
+    SIKTEC_EPD *boards[2] = { nativeCreateBoard(driver, false), nativeCreateBoard(driver, true) };
+
+    printf("{\n  \"benchmark\": \"images\",\n  \"driver\": \"%s\",\n  \"repeats\": %d,\n  \"results\": [",
+        native_driver_names[driver], repeats
+    );
+    bool first = true;
+    for (size_t i = 0; i < images.size(); i++) {
+        SIKTEC_EPD_BITMAP bmp(&sd, images[i].c_str());
+        for (uint8_t sram = 0; sram < 2; sram++) {
+            SIKTEC_EPD *epd = boards[sram];
+            uint32_t pixels = (uint32_t)min(bmp.width(), (int32_t)epd->width()) * min(bmp.height(), (int32_t)epd->height());
+            for (uint8_t f = 0; f <= (uint8_t)BITMAP_FILTER::DITHER_BWR; f++) {
+                EPD_BITMAP_STATUS status = EPD_BITMAP_STATUS::DONE;
+                native_stats_t stats;
+                uint64_t best = 0;
+                for (int r = 0; r < repeats; r++) {
+                    epd->clearBuffer();
+                    nativeResetStats();
+                    uint64_t start = nativeHostNanos();
+                    status = bmp.drawBitmap((BITMAP_FILTER)f, 0, 0, epd);
+                    uint64_t took = nativeHostNanos() - start;
+                    stats = native_stats;
+                    if (r == 0 || took < best) best = took;
+                }
+                bool ok = status == EPD_BITMAP_STATUS::DONE;
+                printf("%s\n    {\"image\": \"%s\", \"width\": %ld, \"height\": %ld, \"bpp\": %u, \"compression\": %u, "
+                       "\"mode\": \"%s\", \"filter\": \"%s\", \"path\": \"%s\", \"status\": %d, \"pixels\": %lu, "
+                       "\"host_ns\": %llu, \"host_pixels_per_s\": %.0f, \"sim_us\": %llu, \"sim_pixels_per_s\": %.0f, "
+                       "\"sd_bytes\": %llu, \"sd_reads\": %llu, \"sd_seeks\": %llu, \"sd_opens\": %llu, "
+                       "\"spi_transactions\": %llu, \"sram_transactions\": %llu, \"crc\": \"%016llx\"}",
+                    first ? "" : ",",
+                    images[i].c_str(), (long)bmp.width(), (long)bmp.height(),
+                    (unsigned)bmp.definition.info_header.bpp, (unsigned)bmp.definition.info_header.compression,
+                    sram ? "SRAM" : "RAM", native_filter_names[f],
+                    f == (uint8_t)BITMAP_FILTER::DITHER_BW || f == (uint8_t)BITMAP_FILTER::DITHER_GRAY4 
+                        || f == (uint8_t)BITMAP_FILTER::DITHER_BWR ? "drawBitmapDithered" : "drawBitmap",
+                    (int)status, (unsigned long)(ok ? pixels : 0),
+                    (unsigned long long)best, ok && best ? pixels * 1e9 / best : 0.0,
+                    (unsigned long long)stats.sim_micros, ok && stats.sim_micros ? pixels * 1e6 / stats.sim_micros : 0.0,
+                    (unsigned long long)stats.sd_bytes, (unsigned long long)stats.sd_reads,
+                    (unsigned long long)stats.sd_seeks, (unsigned long long)stats.sd_opens,
+                    (unsigned long long)stats.spi_transactions, (unsigned long long)stats.sram_transactions,
+                    (unsigned long long)nativePlanesChecksum(epd)
+                );
+                first = false;
+            }
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
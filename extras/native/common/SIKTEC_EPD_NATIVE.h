@@ -0,0 +1,136 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Helpers shared by the native programs (regression and benchmarks):
+ *  board creation for every driver, framebuffer checksums, bitmap listing
+ *  of a host directory and a host wall clock.
+*******************************************************************************/
+
+/**  @file SIKTEC_EPD_NATIVE.h */
+#pragma once
+
+//Host headers first - Arduino.h defines min / max macros:
+#include <dirent.h>
+#include <time.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <Arduino.h>
+#include <SdFat.h>
+#include <SIKTEC_EPD.h>
+
+#define NATIVE_PIN_CS   1
+#define NATIVE_PIN_SRAM 2
+#define NATIVE_PIN_DC   3
+#define NATIVE_PIN_RST  4
+#define NATIVE_PIN_BUSY 5
+
+#define NATIVE_DRIVERS  3
+
+namespace SIKtec {
+
+static const char * const native_driver_names[NATIVE_DRIVERS] = { "G4", "3CU", "3CS" };
+static const char * const native_filter_names[] = { 
+    "GRAY4", "BWR", "BW", "QUANTIZE", "DITHER_BW", "DITHER_GRAY4", "ORDERED_BW", "ORDERED_BWR", "ORDERED_GRAY4", 
+    "DITHER_BWR" 
+};
+
+/**
+ * @brief creates and initializes a board - the 3CS busy line is active HIGH.
+ *
+ * @param driver    0 - G4 (in grayscale mode), 1 - 3CU, 2 - 3CS.
+ * @param sram      use the SRAM framebuffer.
+ * @return SIKTEC_EPD*
+ */
+inline SIKTEC_EPD *nativeCreateBoard(uint8_t driver, bool sram) {
+    epd_pins_t pins = { NATIVE_PIN_CS, (int8_t)(sram ? NATIVE_PIN_SRAM : -1), NATIVE_PIN_DC, NATIVE_PIN_RST, NATIVE_PIN_BUSY };
+    nativeSetPinLevel(NATIVE_PIN_BUSY, driver == 2 ? LOW : HIGH);
+    switch (driver) {
+        case 0: {
+            SIKTEC_EPD_G4 *board = new SIKTEC_EPD_G4(pins);
+            board->begin(EPD_MODE_GRAYSCALE4);
+            return board;
+        }
+        case 1: {
+            SIKTEC_EPD_3CU *board = new SIKTEC_EPD_3CU(pins);
+            board->begin();
+            return board;
+        }
+        default: {
+            SIKTEC_EPD_3CS *board = new SIKTEC_EPD_3CS(pins);
+            board->begin();
+            return board;
+        }
+    }
+}
+
+/**
+ * @brief the driver index of a driver name - -1 when unknown.
+ */
+inline int8_t nativeDriverIndex(const char *name) {
+    for (uint8_t d = 0; d < NATIVE_DRIVERS; d++) {
+        if (strcmp(name, native_driver_names[d]) == 0) return d;
+    }
+    return -1;
+}
+
+/**
+ * @brief FNV-1a over both framebuffer planes - reads through the public plane API.
+ */
+inline uint64_t nativePlanesChecksum(SIKTEC_EPD *epd) {
+    uint64_t hash = 1469598103934665603ULL;
+    uint8_t  buffer[64];
+    for (uint8_t p = 0; p < 2; p++) {
+        epd_plane_t plane = p ? EPD_PLANE_COLOR : EPD_PLANE_BLACK;
+        uint32_t size = epd->planeSize(plane);
+        for (uint32_t offset = 0; offset < size; offset += sizeof(buffer)) {
+            uint16_t len = size - offset > sizeof(buffer) ? sizeof(buffer) : size - offset;
+            epd->readPlane(plane, offset, buffer, len);
+            for (uint16_t i = 0; i < len; i++) {
+                hash ^= buffer[i];
+                hash *= 1099511628211ULL;
+            }
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief the sorted .bmp file names of a host directory.
+ *
+ * @param dir       the host directory.
+ * @param contains  only names containing this string - nullptr for all.
+ */
+inline std::vector<std::string> nativeListBitmaps(const char *dir, const char *contains = nullptr) {
+    std::vector<std::string> names;
+    DIR *d = opendir(dir);
+    if (d == nullptr) {
+        return names;
+    }
+    for (struct dirent *entry = readdir(d); entry != nullptr; entry = readdir(d)) {
+        std::string name(entry->d_name);
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".bmp") == 0
+            && (contains == nullptr || name.find(contains) != std::string::npos)
+        ) {
+            names.push_back(name);
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+/**
+ * @brief host monotonic clock in nano seconds - the real CPU cost, not the simulated time.
+ */
+inline uint64_t nativeHostNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+}
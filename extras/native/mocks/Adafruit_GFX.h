@@ -0,0 +1,79 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Native stand-in for Adafruit_GFX. Implements the subset of the API that 
+ * SIKTEC_EPD and the examples use with the same primitive decomposition as
+ * the real library (every primitive ends up in drawPixel) so the per pixel 
+ * cost measured natively matches what the boards pay.
+ * Text uses a synthetic 5x7 glyph generator instead of glcdfont - the pixel
+ * count per character is in the same range, the shapes are not.
+*******************************************************************************/
+
+/**  @file Adafruit_GFX.h */
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Adafruit_GFX mock.
+ */
+class Adafruit_GFX : public Print {
+
+public:
+
+    Adafruit_GFX(int16_t w, int16_t h);
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    virtual void startWrite() {}
+    virtual void endWrite() {}
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color) { this->drawPixel(x, y, color); }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+
+    virtual void setRotation(uint8_t r);
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void fillScreen(uint16_t color);
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+    void setCursor(int16_t x, int16_t y) { this->cursor_x = x; this->cursor_y = y; }
+    void setTextColor(uint16_t c) { this->textcolor = this->textbgcolor = c; }
+    void setTextColor(uint16_t c, uint16_t bg) { this->textcolor = c; this->textbgcolor = bg; }
+    void setTextSize(uint8_t s) { this->textsize = s > 0 ? s : 1; }
+    void setTextWrap(bool w) { this->wrap = w; }
+    virtual size_t write(uint8_t c);
+
+    int16_t width(void) const { return this->_width; }
+    int16_t height(void) const { return this->_height; }
+    uint8_t getRotation(void) const { return this->rotation; }
+    int16_t getCursorX(void) const { return this->cursor_x; }
+    int16_t getCursorY(void) const { return this->cursor_y; }
+
+protected:
+
+    int16_t  WIDTH;
+    int16_t  HEIGHT;
+    int16_t  _width;
+    int16_t  _height;
+    int16_t  cursor_x = 0;
+    int16_t  cursor_y = 0;
+    uint16_t textcolor = 0xFFFF;
+    uint16_t textbgcolor = 0xFFFF;
+    uint8_t  textsize = 1;
+    uint8_t  rotation = 0;
+    bool     wrap = true;
+};
@@ -0,0 +1,2 @@
+/**  @file Adafruit_I2CDevice.h - native placeholder, examples include it for platformio. */
+#pragma once
@@ -0,0 +1,124 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Host (native) mock of the Arduino core used by SIKTEC_EPD.
+ * Only what the library touches is implemented: timing, digital pins,
+ * a printing Serial and a few helpers. Time is simulated - delay() and
+ * every mocked bus transfer advance the clock instead of sleeping.
+ * Input pins read HIGH unless set with nativeSetPinLevel() - e.g. the 3CS
+ * busy line is active HIGH and must be set LOW before begin().
+*******************************************************************************/
+
+/**  @file Arduino.h */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#define HIGH    0x1
+#define LOW     0x0
+#define INPUT   0x0
+#define OUTPUT  0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_pointer(addr) (*(void * const *)(addr))
+
+#ifndef min
+    #define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef max
+    #define max(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+/**
+ * @brief counters collected by the native mocks - reset with nativeResetStats().
+ */
+typedef struct NativeStats {
+    uint64_t sim_micros       = 0; ///< simulated time in micro seconds
+    uint64_t gpio_writes      = 0; ///< digitalWrite calls
+    uint64_t spi_bytes        = 0; ///< bytes clocked to the EPD controller
+    uint64_t spi_transactions = 0; ///< EPD SPI transactions (write / read / transfer batches)
+    uint64_t sram_bytes       = 0; ///< bytes moved to / from the SRAM chip
+    uint64_t sram_transactions = 0; ///< SRAM read / write transactions
+    uint64_t sd_bytes         = 0; ///< bytes read from files
+    uint64_t sd_reads         = 0; ///< read calls on files
+    uint64_t sd_seeks         = 0; ///< seek calls that moved the cursor
+    uint64_t sd_opens         = 0; ///< file open calls
+} native_stats_t;
+
+extern native_stats_t native_stats;
+
+/** @brief reset all the mock counters (and the simulated clock). */
+void nativeResetStats();
+
+/** @brief advance the simulated clock by a number of nano seconds. */
+void nativeAdvanceNanos(uint64_t nanos);
+
+/** @brief simulated bus cost of a transfer - bytes at a given SPI frequency. */
+void nativeChargeSpi(uint64_t bytes, uint32_t frequency);
+
+/** @brief the level digitalRead() returns for a pin. */
+void nativeSetPinLevel(uint8_t pin, uint8_t level);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+void yield();
+
+/**
+ * @brief minimal Print / Stream implementation writing to stdout.
+ */
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+    size_t print(const char *s)             { size_t n = 0; while (*s) n += this->write((uint8_t)*s++); return n; }
+    size_t print(char c)                    { return this->write((uint8_t)c); }
+    size_t print(int n, int base = DEC)     { return this->print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return this->print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+    size_t println()                        { return this->write('\n'); }
+    template <typename T> size_t println(T v) { size_t n = this->print(v); return n + this->println(); }
+    template <typename T> size_t println(T v, int f) { size_t n = this->print(v, f); return n + this->println(); }
+    int printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
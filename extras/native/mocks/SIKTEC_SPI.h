@@ -0,0 +1,68 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Native mock of SIKTEC_SPI (1.0.2 API) - the EPD controller side of the bus.
+ * Every byte is counted in native_stats.spi_bytes and charged to the 
+ * simulated clock at the configured frequency. Bytes written while the EPD
+ * is in data mode after a RAM write command are captured so the host can
+ * inspect what the panel would have received (nativePanelRam()).
+*******************************************************************************/
+
+/**  @file SIKTEC_SPI.h */
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+
+enum SIKSPI_BitOrder {
+    SIKSPI_BITORDER_MSBFIRST = MSBFIRST,
+    SIKSPI_BITORDER_LSBFIRST = LSBFIRST
+};
+
+/**
+ * @brief SIKTEC_SPI device mock.
+ */
+class SIKTEC_SPI {
+
+    int8_t   _cs;
+    uint32_t _freq;
+    bool     _toggle = true;
+    bool     _in_transaction = false;
+
+    void _count(const size_t len);
+
+public:
+
+    SIKTEC_SPI(
+        int8_t cspin, int8_t sckpin, int8_t misopin, int8_t mosipin, 
+        uint32_t freq = 1000000, SIKSPI_BitOrder dataOrder = SIKSPI_BITORDER_MSBFIRST, uint8_t dataMode = SPI_MODE0
+    );
+    SIKTEC_SPI(
+        int8_t cspin, uint32_t freq = 1000000, SIKSPI_BitOrder dataOrder = SIKSPI_BITORDER_MSBFIRST, 
+        uint8_t dataMode = SPI_MODE0, SPIClass *theSPI = &SPI
+    );
+
+    bool begin();
+    void beginTransaction();
+    void endTransaction();
+    void disableCsToggle();
+    void enableCsToggle();
+    uint8_t transfer(uint8_t send);
+    void transfer(uint8_t *buffer, size_t len);
+    bool read(uint8_t *buffer, size_t len, uint8_t sendvalue = 0xFF);
+    bool write(const uint8_t *buffer, size_t len, const uint8_t *prefix_buffer = nullptr, size_t prefix_len = 0, bool invert = false);
+    uint8_t write_and_read(uint8_t cmd);
+};
+
+/**
+ * @brief the bytes the mocked panel controller received through RAM write commands.
+ *        index 0 / 1 -> the two RAM locations, sized by nativePanelRamSize().
+ */
+uint8_t *nativePanelRam(uint8_t location);
+
+/** @brief the number of bytes captured for a panel RAM location since the last write command. */
+uint32_t nativePanelRamSize(uint8_t location);
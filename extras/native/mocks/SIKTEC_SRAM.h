@@ -0,0 +1,65 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Native mock of SIKTEC_SRAM (1.0.2 API) backed by a host memory array that 
+ * mimics a 23K256 (32KB). Each read / write is one transaction: the command
+ * and 16bit address (3 bytes) plus the payload are charged to the clock.
+*******************************************************************************/
+
+/**  @file SIKTEC_SRAM.h */
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define SIK_SRAM_READ   0x03
+#define SIK_SRAM_WRITE  0x02
+#define SIK_SRAM_RDSR   0x05
+#define SIK_SRAM_WRSR   0x01
+
+#ifndef NATIVE_SRAM_SIZE
+    #define NATIVE_SRAM_SIZE 32768
+#endif
+
+enum SRAM_MODE : uint8_t {
+    SRAM_BYTE_MODE = 0x00,
+    SRAM_PAGE_MODE = 0x80,
+    SRAM_SEQ_MODE  = 0x40
+};
+
+/**
+ * @brief SIKTEC_SRAM chip mock.
+ */
+class SIKTEC_SRAM {
+
+    uint8_t  _mem[NATIVE_SRAM_SIZE];
+    uint32_t _freq;
+    uint8_t  _mode = SRAM_BYTE_MODE;
+
+    void _count(const size_t len);
+
+public:
+
+    SIKTEC_SRAM(int8_t mosi, int8_t miso, int8_t sck, int8_t cs, uint32_t freq = 4000000);
+    SIKTEC_SRAM(int8_t cs, SPIClass *spi = &SPI, uint32_t freq = 4000000);
+
+    void begin();
+    bool set_mode(SRAM_MODE mode);
+    void print_status();
+    void csLow();
+    void csHigh();
+    void disableCsToggle();
+    void enableCsToggle();
+    void write(uint16_t addr, uint8_t *buf, uint16_t num, uint8_t reg = SIK_SRAM_WRITE);
+    void read(uint16_t addr, uint8_t *buf, uint16_t num, uint8_t reg = SIK_SRAM_READ);
+    uint8_t read8(uint16_t addr, uint8_t reg = SIK_SRAM_READ);
+    uint16_t read16(uint16_t addr);
+    void write8(uint16_t addr, uint8_t val, uint8_t reg = SIK_SRAM_WRITE);
+    void write16(uint16_t addr, uint16_t val);
+    void erase(uint16_t addr, uint16_t length, uint8_t val = 0x00);
+    uint8_t *memory() { return this->_mem; } ///< native only - direct view of the chip.
+};
@@ -0,0 +1,41 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+
+/**  @file SPI.h - native mock of the Arduino SPI core. */
+#pragma once
+
+#include <Arduino.h>
+
+#define MSBFIRST  1
+#define LSBFIRST  0
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+/** @brief SPI bus settings - only the clock is used by the native mock. */
+class SPISettings {
+public:
+    uint32_t clock;
+    uint8_t  bitOrder;
+    uint8_t  dataMode;
+    SPISettings(uint32_t _clock = 4000000, uint8_t _bitOrder = MSBFIRST, uint8_t _dataMode = SPI_MODE0)
+        : clock(_clock), bitOrder(_bitOrder), dataMode(_dataMode) {}
+};
+
+/** @brief SPI bus - transfers are loop-backed and only charged to the simulated clock. */
+class SPIClass {
+public:
+    uint32_t clock = 4000000;
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings settings) { this->clock = settings.clock; }
+    void endTransaction() {}
+    uint8_t transfer(uint8_t data) { nativeChargeSpi(1, this->clock); return data; }
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,120 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Native mock of the SdFat (Adafruit fork 1.x) classes used by SIKTEC_EPD.
+ * Files are served from a host directory set with SdFat::begin(root),
+ * nativeSetSdRoot() or the SIKTEC_EPD_SD_ROOT environment variable.
+ * Reads, seeks and opens are counted in native_stats and charged to the
+ * simulated clock with a simple SD cost model:
+ *   - open  : NATIVE_SD_OPEN_NS
+ *   - seek  : NATIVE_SD_SEEK_NS when the cursor actually moves
+ *   - read  : NATIVE_SD_CALL_NS per call + NATIVE_SD_BYTE_NS per byte
+*******************************************************************************/
+
+/**  @file SdFat.h */
+#pragma once
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#ifndef NATIVE_SD_OPEN_NS
+    #define NATIVE_SD_OPEN_NS   2000000UL // FAT lookup ~2ms
+#endif
+#ifndef NATIVE_SD_SEEK_NS
+    #define NATIVE_SD_SEEK_NS   150000UL  // cluster walk + block reload ~150us
+#endif
+#ifndef NATIVE_SD_CALL_NS
+    #define NATIVE_SD_CALL_NS   2000UL    // per call overhead
+#endif
+#ifndef NATIVE_SD_BYTE_NS
+    #define NATIVE_SD_BYTE_NS   400UL     // ~20Mhz SPI
+#endif
+
+typedef uint8_t oflag_t;
+#define O_READ   0x01
+#define O_RDONLY 0x01
+#define O_WRITE  0x02
+#define O_WRONLY 0x02
+#define O_RDWR   0x03
+#define O_APPEND 0x04
+#define O_CREAT  0x10
+#define O_TRUNC  0x20
+#define O_EXCL   0x40
+#define O_AT_END 0x08
+
+/** @brief FAT directory entry subset - only what SIKTEC_EPD reads. */
+typedef struct directoryEntry {
+    uint32_t fileSize;
+    uint16_t lastWriteDate;
+    uint16_t lastWriteTime;
+} dir_t;
+
+/**
+ * @brief FatFile mock - a host FILE* wrapper.
+ */
+class FatFile {
+
+    FILE    *_fp = nullptr;
+    char     _path[512] = { 0 };
+    uint32_t _size = 0;
+    uint32_t _pos = 0;
+    bool     _dir = false;
+    uint16_t _mdate = 0;
+    uint16_t _mtime = 0;
+
+public:
+
+    FatFile() {}
+    FatFile(const char *path, oflag_t oflag) { this->open(path, oflag); }
+    FatFile(const FatFile &other) { *this = other; }
+    FatFile &operator=(const FatFile &other);
+    ~FatFile() {}
+
+    bool open(const char *path, oflag_t oflag = O_RDONLY);
+    bool open(FatFile *dirFile, const char *path, oflag_t oflag = O_RDONLY);
+    bool openNext(FatFile *dirFile, oflag_t oflag = O_RDONLY);
+    bool close();
+    bool isOpen() const { return this->_fp != nullptr || this->_dir; }
+    bool isFile() const { return this->_fp != nullptr; }
+    bool isDir() const { return this->_dir; }
+    bool isHidden() const { return false; }
+    bool getName(char *name, size_t size);
+    bool dirEntry(dir_t *dir);
+    uint32_t fileSize() const { return this->_size; }
+    uint32_t curPosition() const { return this->_pos; }
+    bool seekSet(uint32_t pos);
+    bool seekCur(int32_t offset) { return this->seekSet(this->_pos + offset); }
+    void rewind() { this->seekSet(0); }
+    int  read();
+    int  read(void *buf, size_t nbyte);
+    int  peek();
+    int  available() { return this->_size - this->_pos; }
+    size_t write(uint8_t b) { return this->write(&b, 1); }
+    size_t write(const void *buf, size_t nbyte);
+    bool sync();
+    operator bool() const { return this->isOpen(); }
+};
+
+typedef FatFile File;
+
+/**
+ * @brief SdFat volume mock - maps paths to a host directory.
+ */
+class SdFat {
+public:
+    bool begin(uint8_t csPin = 0, SPISettings settings = SPISettings()) { (void)csPin; (void)settings; return true; }
+    bool begin(const char *root);
+    bool exists(const char *path);
+    bool remove(const char *path);
+    bool chvol() { return true; }
+    FatFile *vwd();
+    void initErrorHalt(Print *pr) { pr->println("SD init error"); exit(1); }
+    FatFile open(const char *path, oflag_t oflag = O_RDONLY) { FatFile f; f.open(path, oflag); return f; }
+};
+
+/** @brief set the host directory that acts as the card root. */
+void nativeSetSdRoot(const char *root);
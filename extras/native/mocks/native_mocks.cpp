@@ -0,0 +1,652 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+
+/**  @file native_mocks.cpp - implementation of the native (host) mocks. */
+/*****************************      NOTES       *******************************
+ * Built by the [env:native] platformio environment, or directly:
+ *   g++ -std=gnu++11 -O2 -I extras/native/mocks -I src \
+ *       extras/native/mocks/native_mocks.cpp src/SIKTEC_EPD.cpp src/bitmap/SIKTEC_*.cpp \
+ *       extras/native/regression/main.cpp -o epd_native
+*******************************************************************************/
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <SIKTEC_SPI.h>
+#include <SIKTEC_SRAM.h>
+#include <SdFat.h>
+#include <Adafruit_GFX.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <dirent.h>
+
+native_stats_t native_stats;
+HardwareSerial Serial;
+SPIClass SPI;
+
+//------------------------------------------------------------------------//
+// Arduino core:
+//------------------------------------------------------------------------//
+
+static uint64_t native_nanos = 0;
+
+void nativeResetStats() {
+    native_stats = native_stats_t();
+    native_nanos = 0;
+}
+
+void nativeAdvanceNanos(uint64_t nanos) {
+    native_nanos += nanos;
+    native_stats.sim_micros = native_nanos / 1000;
+}
+
+void nativeChargeSpi(uint64_t bytes, uint32_t frequency) {
+    if (frequency == 0) frequency = 1000000;
+    nativeAdvanceNanos(bytes * 8ULL * 1000000000ULL / frequency);
+}
+
+unsigned long millis() { return (unsigned long)(native_nanos / 1000000ULL); }
+unsigned long micros() { return (unsigned long)(native_nanos / 1000ULL); }
+void delay(unsigned long ms) { nativeAdvanceNanos((uint64_t)ms * 1000000ULL); }
+void delayMicroseconds(unsigned int us) { nativeAdvanceNanos((uint64_t)us * 1000ULL); }
+void yield() {}
+
+static uint8_t native_pins[256];
+static uint8_t native_inputs[256];
+static bool    native_inputs_set = false;
+
+void nativeSetPinLevel(uint8_t pin, uint8_t level) {
+    if (!native_inputs_set) {
+        memset(native_inputs, HIGH, sizeof(native_inputs));
+        native_inputs_set = true;
+    }
+    native_inputs[pin] = level;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t val) {
+    native_pins[pin] = val;
+    native_stats.gpio_writes++;
+}
+int digitalRead(uint8_t pin) {
+    // The panel never blocks natively - busy lines read their idle level:
+    return native_inputs_set ? native_inputs[pin] : HIGH;
+}
+
+size_t Print::print(unsigned long n, int base) {
+    char buf[8 * sizeof(long) + 1];
+    char *str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if (base < 2) base = 10;
+    do {
+        char c = n % base;
+        n /= base;
+        *--str = c < 10 ? c + '0' : c + 'A' - 10;
+    } while (n);
+    return this->print((const char *)str);
+}
+
+size_t Print::print(long n, int base) {
+    if (n < 0 && base == DEC) {
+        return this->write('-') + this->print((unsigned long)(-n), base);
+    }
+    return this->print((unsigned long)n, base);
+}
+
+size_t Print::print(double n, int digits) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return this->print((const char *)buf);
+}
+
+int Print::printf(const char *format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    this->print((const char *)buf);
+    return n;
+}
+
+//------------------------------------------------------------------------//
+// SRAM <-> EPD bridge + panel RAM capture:
+//------------------------------------------------------------------------//
+
+static SIKTEC_SRAM *bridge_sram   = nullptr; // SRAM that streams to the bus while its cs is held low
+static uint32_t     bridge_addr   = 0;
+static int8_t       capture_loc   = -1;
+static uint8_t      panel_ram[2][65536];
+static uint32_t     panel_size[2] = { 0, 0 };
+
+static uint8_t bridgeNext() {
+    if (bridge_sram == nullptr) return 0xFF;
+    return bridge_sram->memory()[(bridge_addr++) % NATIVE_SRAM_SIZE];
+}
+
+static void captureByte(uint8_t b) {
+    if (capture_loc < 0) return;
+    if (panel_size[capture_loc] < sizeof(panel_ram[0])) {
+        panel_ram[capture_loc][panel_size[capture_loc]++] = b;
+    }
+}
+
+uint8_t *nativePanelRam(uint8_t location) {
+    return panel_ram[location & 1];
+}
+
+uint32_t nativePanelRamSize(uint8_t location) {
+    return panel_size[location & 1];
+}
+
+//------------------------------------------------------------------------//
+// SIKTEC_SPI:
+//------------------------------------------------------------------------//
+
+SIKTEC_SPI::SIKTEC_SPI(
+    int8_t cspin, int8_t sckpin, int8_t misopin, int8_t mosipin,
+    uint32_t freq, SIKSPI_BitOrder dataOrder, uint8_t dataMode
+) : _cs(cspin), _freq(freq) {
+    (void)sckpin; (void)misopin; (void)mosipin; (void)dataOrder; (void)dataMode;
+}
+
+SIKTEC_SPI::SIKTEC_SPI(int8_t cspin, uint32_t freq, SIKSPI_BitOrder dataOrder, uint8_t dataMode, SPIClass *theSPI)
+    : _cs(cspin), _freq(freq) {
+    (void)dataOrder; (void)dataMode; (void)theSPI;
+}
+
+void SIKTEC_SPI::_count(const size_t len) {
+    native_stats.spi_bytes += len;
+    if (!this->_in_transaction) {
+        native_stats.spi_transactions++;
+    }
+    nativeChargeSpi(len, this->_freq);
+}
+
+bool SIKTEC_SPI::begin() { return true; }
+
+void SIKTEC_SPI::beginTransaction() {
+    this->_in_transaction = true;
+    native_stats.spi_transactions++;
+}
+
+void SIKTEC_SPI::endTransaction() { this->_in_transaction = false; }
+
+void SIKTEC_SPI::disableCsToggle() { this->_toggle = false; }
+
+void SIKTEC_SPI::enableCsToggle() {
+    this->_toggle = true;
+    capture_loc = -1;
+}
+
+uint8_t SIKTEC_SPI::transfer(uint8_t send) {
+    this->_count(1);
+    captureByte(send);
+    return bridgeNext();
+}
+
+void SIKTEC_SPI::transfer(uint8_t *buffer, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        buffer[i] = this->transfer(buffer[i]);
+    }
+}
+
+bool SIKTEC_SPI::read(uint8_t *buffer, size_t len, uint8_t sendvalue) {
+    (void)sendvalue;
+    this->_count(len);
+    for (size_t i = 0; i < len; ++i) {
+        buffer[i] = bridgeNext();
+    }
+    return true;
+}
+
+bool SIKTEC_SPI::write(const uint8_t *buffer, size_t len, const uint8_t *prefix_buffer, size_t prefix_len, bool invert) {
+    this->_count(len + prefix_len);
+    for (size_t i = 0; i < len; ++i) {
+        captureByte(invert ? ~buffer[i] : buffer[i]);
+    }
+    (void)prefix_buffer;
+    return true;
+}
+
+uint8_t SIKTEC_SPI::write_and_read(uint8_t cmd) {
+    this->_count(1);
+    // Only RAM write commands are sent with a read back - start capturing the data that follows:
+    switch (cmd) {
+        case 0x10: case 0x24: capture_loc = 0; break;
+        case 0x13: case 0x26: capture_loc = 1; break;
+        default: capture_loc = -1;
+    }
+    if (capture_loc >= 0) {
+        panel_size[capture_loc] = 0;
+    }
+    return bridgeNext();
+}
+
+//------------------------------------------------------------------------//
+// SIKTEC_SRAM:
+//------------------------------------------------------------------------//
+
+SIKTEC_SRAM::SIKTEC_SRAM(int8_t mosi, int8_t miso, int8_t sck, int8_t cs, uint32_t freq) : _freq(freq) {
+    (void)mosi; (void)miso; (void)sck; (void)cs;
+    memset(this->_mem, 0, sizeof(this->_mem));
+}
+
+SIKTEC_SRAM::SIKTEC_SRAM(int8_t cs, SPIClass *spi, uint32_t freq) : _freq(freq) {
+    (void)cs; (void)spi;
+    memset(this->_mem, 0, sizeof(this->_mem));
+}
+
+void SIKTEC_SRAM::_count(const size_t len) {
+    native_stats.sram_transactions++;
+    native_stats.sram_bytes += len;
+    nativeChargeSpi(len + 3, this->_freq); // command + 16bit address
+}
+
+void SIKTEC_SRAM::begin() {}
+
+bool SIKTEC_SRAM::set_mode(SRAM_MODE mode) {
+    this->_mode = mode;
+    return true;
+}
+
+void SIKTEC_SRAM::print_status() { Serial.println("SRAM mock OK"); }
+void SIKTEC_SRAM::csLow() {}
+void SIKTEC_SRAM::csHigh() { bridge_sram = nullptr; }
+void SIKTEC_SRAM::disableCsToggle() {}
+void SIKTEC_SRAM::enableCsToggle() { bridge_sram = nullptr; }
+
+void SIKTEC_SRAM::write(uint16_t addr, uint8_t *buf, uint16_t num, uint8_t reg) {
+    if (reg == SIK_SRAM_READ) {
+        // Put the chip in read mode and leave it streaming onto the bus:
+        this->_count(0);
+        bridge_sram = this;
+        bridge_addr = addr;
+        return;
+    }
+    this->_count(num);
+    for (uint16_t i = 0; i < num; ++i) {
+        this->_mem[(uint32_t)(addr + i) % NATIVE_SRAM_SIZE] = buf[i];
+    }
+}
+
+void SIKTEC_SRAM::read(uint16_t addr, uint8_t *buf, uint16_t num, uint8_t reg) {
+    (void)reg;
+    this->_count(num);
+    for (uint16_t i = 0; i < num; ++i) {
+        buf[i] = this->_mem[(uint32_t)(addr + i) % NATIVE_SRAM_SIZE];
+    }
+}
+
+uint8_t SIKTEC_SRAM::read8(uint16_t addr, uint8_t reg) {
+    uint8_t v;
+    this->read(addr, &v, 1, reg);
+    return v;
+}
+
+uint16_t SIKTEC_SRAM::read16(uint16_t addr) {
+    uint8_t b[2];
+    this->read(addr, b, 2);
+    return ((uint16_t)b[0] << 8) | b[1];
+}
+
+void SIKTEC_SRAM::write8(uint16_t addr, uint8_t val, uint8_t reg) {
+    this->write(addr, &val, 1, reg);
+}
+
+void SIKTEC_SRAM::write16(uint16_t addr, uint16_t val) {
+    uint8_t b[2] = { (uint8_t)(val >> 8), (uint8_t)(val & 0xFF) };
+    this->write(addr, b, 2);
+}
+
+void SIKTEC_SRAM::erase(uint16_t addr, uint16_t length, uint8_t val) {
+    this->_count(length);
+    for (uint32_t i = 0; i < length; ++i) {
+        this->_mem[(addr + i) % NATIVE_SRAM_SIZE] = val;
+    }
+}
+
+//------------------------------------------------------------------------//
+// SdFat:
+//------------------------------------------------------------------------//
+
+static char sd_root[256] = { 0 };
+
+void nativeSetSdRoot(const char *root) {
+    strncpy(sd_root, root, sizeof(sd_root) - 1);
+}
+
+static void sdHostPath(const char *path, char *out, size_t size) {
+    //Default root - the SIKTEC_EPD_SD_ROOT environment variable or the working directory:
+    if (!sd_root[0]) {
+        const char *env = getenv("SIKTEC_EPD_SD_ROOT");
+        nativeSetSdRoot(env && env[0] ? env : ".");
+    }
+    while (*path == '/') path++;
+    snprintf(out, size, "%s/%s", sd_root, path);
+}
+
+FatFile &FatFile::operator=(const FatFile &other) {
+    if (this == &other) return *this;
+    this->_fp = nullptr;
+    this->_dir = other._dir;
+    this->_size = other._size;
+    this->_pos = 0;
+    this->_mdate = other._mdate;
+    this->_mtime = other._mtime;
+    memcpy(this->_path, other._path, sizeof(this->_path));
+    // Like SdFat the copy shares the directory entry - reopen a private host handle:
+    if (other._fp != nullptr) {
+        this->_fp = fopen(this->_path, "rb");
+        if (this->_fp) fseek(this->_fp, other._pos, SEEK_SET);
+        this->_pos = other._pos;
+    }
+    return *this;
+}
+
+bool FatFile::open(const char *path, oflag_t oflag) {
+    if (this->isOpen()) return false;
+    char host[512];
+    sdHostPath(path, host, sizeof(host));
+    native_stats.sd_opens++;
+    nativeAdvanceNanos(NATIVE_SD_OPEN_NS);
+    struct stat st;
+    bool exists = stat(host, &st) == 0;
+    if (exists && S_ISDIR(st.st_mode)) {
+        this->_dir = true;
+        snprintf(this->_path, sizeof(this->_path), "%s", host);
+        return true;
+    }
+    const char *mode = "rb";
+    if (oflag & O_WRITE) {
+        if (!exists && !(oflag & O_CREAT)) return false;
+        mode = (oflag & O_TRUNC) || !exists ? "w+b" : "r+b";
+    } else if (!exists) {
+        return false;
+    }
+    this->_fp = fopen(host, mode);
+    if (this->_fp == nullptr) return false;
+    snprintf(this->_path, sizeof(this->_path), "%s", host);
+    this->_pos = 0;
+    if (stat(host, &st) == 0) {
+        this->_size = (uint32_t)st.st_size;
+        struct tm *t = localtime(&st.st_mtime);
+        this->_mdate = (uint16_t)(((t->tm_year - 80) << 9) | ((t->tm_mon + 1) << 5) | t->tm_mday);
+        this->_mtime = (uint16_t)((t->tm_hour << 11) | (t->tm_min << 5) | (t->tm_sec >> 1));
+    }
+    if (oflag & O_AT_END) this->seekSet(this->_size);
+    return true;
+}
+
+bool FatFile::open(FatFile *dirFile, const char *path, oflag_t oflag) {
+    (void)dirFile;
+    return this->open(path, oflag);
+}
+
+bool FatFile::openNext(FatFile *dirFile, oflag_t oflag) {
+    (void)dirFile; (void)oflag;
+    return false;
+}
+
+bool FatFile::close() {
+    if (this->_fp) fclose(this->_fp);
+    this->_fp = nullptr;
+    this->_dir = false;
+    return true;
+}
+
+bool FatFile::getName(char *name, size_t size) {
+    const char *base = strrchr(this->_path, '/');
+    base = base ? base + 1 : this->_path;
+    strncpy(name, base, size - 1);
+    name[size - 1] = '\0';
+    return true;
+}
+
+bool FatFile::dirEntry(dir_t *dir) {
+    if (!this->isOpen()) return false;
+    dir->fileSize = this->_size;
+    dir->lastWriteDate = this->_mdate;
+    dir->lastWriteTime = this->_mtime;
+    return true;
+}
+
+bool FatFile::seekSet(uint32_t pos) {
+    if (this->_fp == nullptr || pos > this->_size) return false;
+    if (pos != this->_pos) {
+        native_stats.sd_seeks++;
+        nativeAdvanceNanos(NATIVE_SD_SEEK_NS);
+        fseek(this->_fp, pos, SEEK_SET);
+        this->_pos = pos;
+    }
+    return true;
+}
+
+int FatFile::read() {
+    uint8_t b;
+    return this->read(&b, 1) == 1 ? b : -1;
+}
+
+int FatFile::read(void *buf, size_t nbyte) {
+    if (this->_fp == nullptr) return -1;
+    size_t n = fread(buf, 1, nbyte, this->_fp);
+    this->_pos += n;
+    native_stats.sd_reads++;
+    native_stats.sd_bytes += n;
+    nativeAdvanceNanos(NATIVE_SD_CALL_NS + (uint64_t)n * NATIVE_SD_BYTE_NS);
+    return (int)n;
+}
+
+int FatFile::peek() {
+    int c = this->read();
+    if (c >= 0) this->seekSet(this->_pos - 1);
+    return c;
+}
+
+size_t FatFile::write(const void *buf, size_t nbyte) {
+    if (this->_fp == nullptr) return 0;
+    size_t n = fwrite(buf, 1, nbyte, this->_fp);
+    this->_pos += n;
+    if (this->_pos > this->_size) this->_size = this->_pos;
+    nativeAdvanceNanos(NATIVE_SD_CALL_NS + (uint64_t)n * NATIVE_SD_BYTE_NS);
+    return n;
+}
+
+bool FatFile::sync() {
+    return this->_fp != nullptr && fflush(this->_fp) == 0;
+}
+
+bool SdFat::begin(const char *root) {
+    nativeSetSdRoot(root);
+    return true;
+}
+
+bool SdFat::exists(const char *path) {
+    char host[512];
+    sdHostPath(path, host, sizeof(host));
+    struct stat st;
+    return stat(host, &st) == 0;
+}
+
+bool SdFat::remove(const char *path) {
+    char host[512];
+    sdHostPath(path, host, sizeof(host));
+    return ::remove(host) == 0;
+}
+
+FatFile *SdFat::vwd() {
+    static FatFile root;
+    return &root;
+}
+
+//------------------------------------------------------------------------//
+// Adafruit_GFX:
+//------------------------------------------------------------------------//
+
+#define GFX_SWAP(a, b) { int16_t t = a; a = b; b = t; }
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+void Adafruit_GFX::setRotation(uint8_t r) {
+    this->rotation = r & 3;
+    if (this->rotation & 1) {
+        this->_width = HEIGHT;
+        this->_height = WIDTH;
+    } else {
+        this->_width = WIDTH;
+        this->_height = HEIGHT;
+    }
+}
+
+void Adafruit_GFX::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; ++i) this->writePixel(x, y + i, color);
+}
+
+void Adafruit_GFX::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; ++i) this->writePixel(x + i, y, color);
+}
+
+void Adafruit_GFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    this->fillRect(x, y, w, h, color);
+}
+
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { GFX_SWAP(x0, y0); GFX_SWAP(x1, y1); }
+    if (x0 > x1) { GFX_SWAP(x0, x1); GFX_SWAP(y0, y1); }
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+        if (steep) this->writePixel(y0, x0, color);
+        else this->writePixel(x0, y0, color);
+        err -= dy;
+        if (err < 0) { y0 += ystep; err += dx; }
+    }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    this->startWrite();
+    this->writeLine(x, y, x, y + h - 1, color);
+    this->endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    this->startWrite();
+    this->writeLine(x, y, x + w - 1, y, color);
+    this->endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    this->startWrite();
+    for (int16_t i = x; i < x + w; i++) this->writeFastVLine(i, y, h, color);
+    this->endWrite();
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+    this->fillRect(0, 0, this->_width, this->_height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    if (x0 == x1) {
+        if (y0 > y1) GFX_SWAP(y0, y1);
+        this->drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    } else if (y0 == y1) {
+        if (x0 > x1) GFX_SWAP(x0, x1);
+        this->drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+        this->startWrite();
+        this->writeLine(x0, y0, x1, y1, color);
+        this->endWrite();
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    this->startWrite();
+    this->writeFastHLine(x, y, w, color);
+    this->writeFastHLine(x, y + h - 1, w, color);
+    this->writeFastVLine(x, y, h, color);
+    this->writeFastVLine(x + w - 1, y, h, color);
+    this->endWrite();
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    this->startWrite();
+    this->writePixel(x0, y0 + r, color);
+    this->writePixel(x0, y0 - r, color);
+    this->writePixel(x0 + r, y0, color);
+    this->writePixel(x0 - r, y0, color);
+    while (x < y) {
+        if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        this->writePixel(x0 + x, y0 + y, color);
+        this->writePixel(x0 - x, y0 + y, color);
+        this->writePixel(x0 + x, y0 - y, color);
+        this->writePixel(x0 - x, y0 - y, color);
+        this->writePixel(x0 + y, y0 + x, color);
+        this->writePixel(x0 - y, y0 + x, color);
+        this->writePixel(x0 + y, y0 - x, color);
+        this->writePixel(x0 - y, y0 - x, color);
+    }
+    this->endWrite();
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    this->startWrite();
+    this->writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x, py = y;
+    while (x < y) {
+        if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        if (x < (y + 1)) {
+            this->writeFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+            this->writeFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+        }
+        if (y != py) {
+            this->writeFastVLine(x0 + py, y0 - px, 2 * px + 1, color);
+            this->writeFastVLine(x0 - py, y0 - px, 2 * px + 1, color);
+            py = y;
+        }
+        px = x;
+    }
+    this->endWrite();
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    this->startWrite();
+    for (int8_t i = 0; i < 5; i++) {
+        // Synthetic glyph column - deterministic pattern with a glcdfont like density:
+        uint8_t line = (uint8_t)((c * 37u + i * 11u) ^ (c >> 1)) & 0x7F;
+        for (int8_t j = 0; j < 8; j++, line >>= 1) {
+            if (line & 1) {
+                if (size == 1) this->writePixel(x + i, y + j, color);
+                else this->writeFillRect(x + i * size, y + j * size, size, size, color);
+            } else if (bg != color) {
+                if (size == 1) this->writePixel(x + i, y + j, bg);
+                else this->writeFillRect(x + i * size, y + j * size, size, size, bg);
+            }
+        }
+    }
+    this->endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        this->cursor_x = 0;
+        this->cursor_y += this->textsize * 8;
+    } else if (c != '\r') {
+        if (this->wrap && ((this->cursor_x + this->textsize * 6) > this->_width)) {
+            this->cursor_x = 0;
+            this->cursor_y += this->textsize * 8;
+        }
+        this->drawChar(this->cursor_x, this->cursor_y, c, this->textcolor, this->textbgcolor, this->textsize);
+        this->cursor_x += this->textsize * 6;
+    }
+    return 1;
+}
@@ -0,0 +1,442 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Native regression run:
+ *  Draws every bitmap of a host directory with every builtin BITMAP_FILTER
+ *  on each driver (G4, 3CU, 3CS) in RAM and SRAM framebuffer modes.
+ *  Then runs the draw cases of the other entry points on each bitmap - clipped 
+ *  and offscreen draws, the inlined template draw, the dither kernels / scan 
+ *  options, the color LUT (RAM and SRAM), the MEMO filter, scaled draws, sprites 
+ *  (single, session batch, cache miss / hit) and an .epd export that is loaded 
+ *  and displayed back (saved full screen).
+ *  Prints one line per draw - the status, a checksum of the framebuffer
+ *  planes and the mock counters (SD bytes / seeks, SPI and SRAM transactions,
+ *  simulated time).
+ * Checks - the run exits with 1 and prints FAIL lines when:
+ *  - the draws that must be equal differ - the template draws and the virtual draws, 
+ *    MEMO and the wrapped filter, cached / uncached sprites, a loaded export and its draw.
+ *  - a fixture differs from its twin (-twin.bmp - the same pixels stored bottom-up and 
+ *    uncompressed) in any case - RLE fixtures skip the dithered cases (dithered bottom to top).
+ *  - a golden file is given and a status / checksum differs from it (or is missing).
+ *  The test images include small RLE4 / RLE8 (with a delta escape), top-down and 
+ *  1bpp fixtures.
+ * Usage:
+ *  pio run -e native && .pio/build/native/program [images dir] [name filter] [golden file]
+ *  the images dir defaults to extras/test_images - the export case writes 
+ *  (and removes) a temporary regression.epd file in it. An empty name filter runs all the images.
+ *  extras/native/regression/golden.txt holds the checksums of the default (565) build - 
+ *  after an intended change regenerate it with:
+ *  program extras/test_images | awk '{print $1, $2, $3, $4, $6, $8}' > extras/native/regression/golden.txt
+*******************************************************************************/
+
+#include <map>
+#include <SIKTEC_EPD_NATIVE.h>
+
+using namespace SIKtec;
+
+#define REGRESSION_EXPORT_FILE "regression.epd"
+#define REGRESSION_TWIN_SUFFIX "-twin.bmp"
+
+static std::map<std::string, std::string> results; // "image driver mode case" -> "status crc"
+static uint32_t failures = 0;
+
+/**
+ * @brief the results key of a draw.
+ */
+static std::string resultKey(const std::string &image, uint8_t driver, bool sram, const char *name) {
+    return image + " " + native_driver_names[driver] + " " + (sram ? "SRAM" : "RAM") + " " + name;
+}
+
+/**
+ * @brief prints a single draw line - the stats are taken since the last nativeResetStats.
+ */
+static void printDraw(const char *image, uint8_t driver, bool sram, const char *name, int status, SIKTEC_EPD *epd) {
+    native_stats_t stats = native_stats;
+    char result[48];
+    snprintf(result, sizeof(result), "%d %016llx", status, (unsigned long long)nativePlanesChecksum(epd));
+    results[resultKey(image, driver, sram, name)] = result;
+    Serial.printf(
+        "%-28s %-3s %-4s %-13s status %d crc %016llx sd_bytes %llu sd_seeks %llu spi_tx %llu sram_tx %llu sim_ms %llu\n",
+        image, native_driver_names[driver], sram ? "SRAM" : "RAM", name, status,
+        (unsigned long long)nativePlanesChecksum(epd),
+        (unsigned long long)stats.sd_bytes, (unsigned long long)stats.sd_seeks,
+        (unsigned long long)stats.spi_transactions, (unsigned long long)stats.sram_transactions,
+        (unsigned long long)(stats.sim_micros / 1000)
+    );
+}
+
+/**
+ * @brief fails when two recorded draws differ - the status and the checksum.
+ * 
+ * @param crc_only compare the checksums only - the statuses of different enums.
+ */
+static void expectSame(const std::string &a, const std::string &b, bool crc_only = false) {
+    std::map<std::string, std::string>::iterator ra = results.find(a), rb = results.find(b);
+    if (ra == results.end() || rb == results.end() || (crc_only 
+        ? ra->second.substr(ra->second.find(' ')) != rb->second.substr(rb->second.find(' ')) 
+        : ra->second != rb->second)
+    ) {
+        Serial.printf("FAIL %s [%s] != %s [%s]\n", 
+            a.c_str(), ra == results.end() ? "missing" : ra->second.c_str(),
+            b.c_str(), rb == results.end() ? "missing" : rb->second.c_str()
+        );
+        failures++;
+    }
+}
+
+/**
+ * @brief whether a case output depends on the rows order (error diffusion) - RLE twins skip it.
+ */
+static bool isDithered(const std::string &name) {
+    return name.find("DITH") != std::string::npos || name.compare(0, 3, "DK_") == 0 || name.compare(0, 6, "IMAGE_") == 0;
+}
+
+/**
+ * @brief compares every case of the fixtures that have a twin.
+ */
+static void checkTwins(const std::vector<std::string> &images) {
+    for (size_t i = 0; i < images.size(); i++) {
+        const std::string &twin = images[i];
+        size_t suffix = twin.size() - strlen(REGRESSION_TWIN_SUFFIX);
+        if (twin.size() <= strlen(REGRESSION_TWIN_SUFFIX) || twin.compare(suffix, std::string::npos, REGRESSION_TWIN_SUFFIX) != 0) {
+            continue;
+        }
+        std::string fixture = twin.substr(0, suffix) + ".bmp";
+        if (std::find(images.begin(), images.end(), fixture) == images.end()) {
+            continue;
+        }
+        bool rle = fixture.find("rle") != std::string::npos;
+        std::string prefix = twin + " ";
+        for (std::map<std::string, std::string>::iterator r = results.lower_bound(prefix); 
+            r != results.end() && r->first.compare(0, prefix.size(), prefix) == 0; ++r
+        ) {
+            std::string rest = r->first.substr(prefix.size());
+            if (rle && isDithered(rest.substr(rest.rfind(' ') + 1))) {
+                continue;
+            }
+            expectSame(fixture + " " + rest, r->first);
+        }
+    }
+}
+
+/**
+ * @brief compares the results with a golden file - "image driver mode case status crc" lines.
+ * Every result must match - without a name filter every golden line must have a result.
+ */
+static void checkGolden(const char *path, bool all) {
+    FILE *golden = fopen(path, "r");
+    if (golden == nullptr) {
+        Serial.printf("FAIL golden file %s not found\n", path);
+        failures++;
+        return;
+    }
+    std::map<std::string, std::string> expected;
+    char image[128], driver[8], mode[8], name[32], status[8], crc[32];
+    while (fscanf(golden, "%127s %7s %7s %31s %7s %31s", image, driver, mode, name, status, crc) == 6) {
+        expected[std::string(image) + " " + driver + " " + mode + " " + name] = std::string(status) + " " + crc;
+    }
+    fclose(golden);
+    for (std::map<std::string, std::string>::iterator r = results.begin(); r != results.end(); ++r) {
+        std::map<std::string, std::string>::iterator e = expected.find(r->first);
+        if (e == expected.end() || e->second != r->second) {
+            Serial.printf("FAIL golden %s [%s] expected [%s]\n", r->first.c_str(), r->second.c_str(), 
+                e == expected.end() ? "missing" : e->second.c_str());
+            failures++;
+        }
+    }
+    for (std::map<std::string, std::string>::iterator e = expected.begin(); all && e != expected.end(); ++e) {
+        if (results.find(e->first) == results.end()) {
+            Serial.printf("FAIL golden %s not drawn\n", e->first.c_str());
+            failures++;
+        }
+    }
+}
+
+/**
+ * @brief runs the draw cases of the non builtin entry points on a single bitmap.
+ */
+static void runCases(SdFat *sd, const char *image, uint8_t driver, bool sram, SIKTEC_EPD *epd) {
+
+    uint16_t colormap[5][4] = {
+        {0,     0,      0,      EPD_BLACK   },
+        {31,    63,     31,     EPD_WHITE   },
+        {11,    22,     11,     EPD_DARK    },
+        {20,    40,     20,     EPD_LIGHT   },
+        {31,    0,      0,      EPD_RED     }
+    };
+    uint16_t colormap_dither[5][4] = {
+        {0,     0,      0,      EPD_BLACK   },
+        {15,    15,     15,     EPD_RED     },
+        {15,    15,     15,     EPD_DARK    },
+        {25,    25,     25,     EPD_LIGHT   },
+        {40,    40,     40,     EPD_WHITE   }
+    };
+    static const bitmap_dither_kernel_t * const kernels[] = {
+        &DITHER_KERNEL_FLOYD, &DITHER_KERNEL_JARVIS, &DITHER_KERNEL_STUCKI, &DITHER_KERNEL_BURKES,
+        &DITHER_KERNEL_SIERRA, &DITHER_KERNEL_SIERRA_TWO_ROW, &DITHER_KERNEL_SIERRA_LITE, &DITHER_KERNEL_ATKINSON
+    };
+    static const char * const kernel_names[] = {
+        "DK_FLOYD", "DK_JARVIS", "DK_STUCKI", "DK_BURKES", "DK_SIERRA", "DK_SIERRA2", "DK_SIERRA_LT", "DK_ATKINSON"
+    };
+
+    SIKTEC_EPD_BITMAP bmp(sd, image);
+    int32_t w = bmp.width();
+    int32_t h = bmp.height() < 0 ? -bmp.height() : bmp.height();
+    //A clip window inside the bitmap and a position that crosses the right / bottom edges:
+    uint32_t sc = w / 5, sr = h / 7, cw = w / 2, ch = h / 2;
+    uint32_t edge_x = epd->width() - w / 3, edge_y = epd->height() - h / 3;
+
+    BitmapFilter_QUANT quant;
+    quant.setColorMap(colormap, 5);
+    BitmapFilter_GRAY4 gray(30);
+    gray.setColorMap(colormap, 4);
+    BitmapFilter_DITHER_BW dither_bw(EPD_BLACK, EPD_WHITE, 1.15);
+    BitmapFilter_DITHER_GRAY4 dither_gray(1);
+    dither_gray.setColorMap(colormap_dither, 5);
+
+    int status;
+
+    //Clipped / offscreen draws:
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap(BITMAP_FILTER::GRAY4, 13, 7, epd, sc, sr, cw, ch);
+    printDraw(image, driver, sram, "CLIP_GRAY4", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap(BITMAP_FILTER::DITHER_BW, 13, 7, epd, sc, sr, cw, ch);
+    printDraw(image, driver, sram, "CLIP_DITH_BW", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap(BITMAP_FILTER::DITHER_BWR, 13, 7, epd, sc, sr, cw, ch);
+    printDraw(image, driver, sram, "CLIP_DITH_BWR", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap(&quant, edge_x, edge_y, epd);
+    printDraw(image, driver, sram, "EDGE_QUANT", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmapDithered(&dither_gray, edge_x, edge_y, epd);
+    printDraw(image, driver, sram, "EDGE_DITH_G4", status, epd);
+
+    //The virtual call draws and the inlined kernel draws (TPL_*) - checked equal:
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap(&quant, 0, 0, epd);
+    printDraw(image, driver, sram, "QUANT", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap<BitmapFilter_QUANT>(&quant, 0, 0, epd);
+    printDraw(image, driver, sram, "TPL_QUANT", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap(&quant, 13, 7, epd, sc, sr, cw, ch);
+    printDraw(image, driver, sram, "CLIP_QUANT", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap<BitmapFilter_QUANT>(&quant, 13, 7, epd, sc, sr, cw, ch);
+    printDraw(image, driver, sram, "TPL_CLIP_QUANT", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmap<BitmapFilter_GRAY4>(&gray, 0, 0, epd);
+    printDraw(image, driver, sram, "TPL_GRAY4", status, epd);
+
+    //MEMO must match the wrapped filter - the LUT maps each quantized RGB cell to the 
+    //closest color of the cell (not of the pixel) so it may differ from QUANT:
+    {
+        BitmapFilter_MEMO memo(&quant, 64);
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)bmp.drawBitmap(&memo, 0, 0, epd);
+        printDraw(image, driver, sram, "MEMO_QUANT", status, epd);
+    }
+    {
+        BITMAP_COLOR_LUT lut(4, 4, 4);
+        quant.setColorLUT(&lut);
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)bmp.drawBitmap(&quant, 0, 0, epd);
+        printDraw(image, driver, sram, "LUT_QUANT", status, epd);
+        quant.setColorLUT(nullptr);
+    }
+    if (sram) {
+        BITMAP_COLOR_LUT lut(4, 4, 3);
+        status = lut.useSram(epd) ? 0 : -1;
+        quant.setColorLUT(&lut);
+        epd->clearBuffer(); nativeResetStats();
+        if (status == 0) status = (int)bmp.drawBitmap(&quant, 0, 0, epd);
+        printDraw(image, driver, sram, "LUT_SRAM_QUANT", status, epd);
+        quant.setColorLUT(nullptr);
+    }
+
+    //Dither kernels and scan options:
+    for (uint8_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        dither_gray.setKernel(kernels[k]);
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)bmp.drawBitmapDithered(&dither_gray, 0, 0, epd);
+        printDraw(image, driver, sram, kernel_names[k], status, epd);
+    }
+    dither_gray.setKernel(&DITHER_KERNEL_STUCKI);
+    dither_gray.setSerpentine(true);
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmapDithered(&dither_gray, 0, 0, epd);
+    printDraw(image, driver, sram, "DK_SERPENTINE", status, epd);
+
+    dither_gray.setStripWidth(24);
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmapDithered(&dither_gray, 0, 0, epd);
+    printDraw(image, driver, sram, "DK_STRIPS", status, epd);
+    dither_gray.setStripWidth(0);
+    dither_gray.setSerpentine(false);
+    dither_gray.setKernel(nullptr);
+
+    dither_gray.setCompactErrors(true);
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmapDithered(&dither_gray, 0, 0, epd);
+    printDraw(image, driver, sram, "DITH_COMPACT", status, epd);
+    dither_gray.setCompactErrors(false);
+
+    //Scaled draws:
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmapScaled(&quant, 5, 5, epd, w / 2 + 1, 0, BITMAP_SCALE::SCALE_BOX);
+    printDraw(image, driver, sram, "SCALE_BOX", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmapScaled(&quant, 5, 5, epd, w / 3 + 1, h / 2 + 1, BITMAP_SCALE::SCALE_NEAREST);
+    printDraw(image, driver, sram, "SCALE_NEAREST", status, epd);
+
+    epd->clearBuffer(); nativeResetStats();
+    status = (int)bmp.drawBitmapScaledDithered(&dither_bw, 5, 5, epd, w / 2 + 1);
+    printDraw(image, driver, sram, "SCALE_DITH_BW", status, epd);
+
+    //Export the dithered draw - load it back and display it:
+    {
+        FatFile out;
+        epd->clearBuffer(); nativeResetStats();
+        status = out.open(REGRESSION_EXPORT_FILE, O_RDWR | O_CREAT | O_TRUNC) ? 0 : -1;
+        if (status == 0) {
+            status = (int)bmp.exportImage(&dither_gray, 13, 7, epd, out, sc, sr, cw, ch);
+            out.close();
+        }
+        printDraw(image, driver, sram, "EXPORT_DITH", status, epd);
+
+        FatFile in;
+        epd->clearBuffer(); nativeResetStats();
+        status = in.open(REGRESSION_EXPORT_FILE, O_RDONLY) ? (int)SIKTEC_EPD_IMAGE::load(epd, in) : -1;
+        in.close();
+        printDraw(image, driver, sram, "IMAGE_LOAD", status, epd);
+
+        //display streams full screen images only - save the loaded framebuffer:
+        nativeResetStats();
+        status = out.open(REGRESSION_EXPORT_FILE, O_RDWR | O_CREAT | O_TRUNC) ? 0 : -1;
+        if (status == 0) {
+            status = (int)SIKTEC_EPD_IMAGE::save(epd, out, 0, 0, epd->width(), epd->height());
+            out.close();
+        }
+        printDraw(image, driver, sram, "IMAGE_SAVE", status, epd);
+
+        //The refresh waits on the busy line - idle it for this driver (the 3CS busy line is active HIGH):
+        nativeSetPinLevel(NATIVE_PIN_BUSY, driver == 2 ? LOW : HIGH);
+        nativeResetStats();
+        status = in.open(REGRESSION_EXPORT_FILE, O_RDONLY) ? (int)SIKTEC_EPD_IMAGE::display(epd, in) : -1;
+        in.close();
+        printDraw(image, driver, sram, "IMAGE_DISPLAY", status, epd);
+        sd->remove(REGRESSION_EXPORT_FILE);
+    }
+
+    //Sprites - the bitmap is split into a 4 x 2 sheet:
+    {
+        SIKTEC_EPD_BITMAP sheet(sd, image);
+        sheet.defineBitmapSprite(4, 2);
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)sheet.drawBitmapSprite(&quant, 10, 10, 5, epd);
+        printDraw(image, driver, sram, "SPRITE", status, epd);
+
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)sheet.drawBitmapSprite(BITMAP_FILTER::GRAY4, edge_x, edge_y, 2, epd);
+        printDraw(image, driver, sram, "SPRITE_EDGE", status, epd);
+
+        bmp_sprite_draw_t batch[4];
+        for (uint8_t s = 0; s < 4; s++) {
+            batch[s].index = (s * 3) % 8;
+            batch[s].x     = 4 + s * (w / 4 + 3);
+            batch[s].y     = s & 1 ? 3 : h / 2 + 6;
+        }
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)sheet.beginSpriteSession(&quant);
+        if (status == (int)EPD_BITMAP_STATUS::VALID) {
+            status = (int)sheet.drawSprites(batch, 4, epd);
+            if (status == (int)EPD_BITMAP_STATUS::DONE) {
+                status = (int)sheet.drawSprite(7, 0, 0, epd);
+            }
+            sheet.endSpriteSession();
+        }
+        printDraw(image, driver, sram, "SPRITE_BATCH", status, epd);
+
+        SIKTEC_EPD_SPRITE_CACHE cache(epd, sram ? 0 : 8192);
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)sheet.drawCachedSprite(&cache, &quant, 5, 10, 10);
+        printDraw(image, driver, sram, "CACHE_MISS", status, epd);
+
+        epd->clearBuffer(); nativeResetStats();
+        status = (int)sheet.drawCachedSprite(&cache, &quant, 5, 10, 10);
+        printDraw(image, driver, sram, "CACHE_HIT", status, epd);
+    }
+
+    //The draws that must be equal:
+    expectSame(resultKey(image, driver, sram, "TPL_QUANT"),       resultKey(image, driver, sram, "QUANT"));
+    expectSame(resultKey(image, driver, sram, "TPL_CLIP_QUANT"),  resultKey(image, driver, sram, "CLIP_QUANT"));
+    expectSame(resultKey(image, driver, sram, "TPL_GRAY4"),       resultKey(image, driver, sram, "GRAY4"));
+    expectSame(resultKey(image, driver, sram, "QUANT"),           resultKey(image, driver, sram, "QUANTIZE"));
+    expectSame(resultKey(image, driver, sram, "MEMO_QUANT"),      resultKey(image, driver, sram, "QUANT"));
+    expectSame(resultKey(image, driver, sram, "CACHE_MISS"),      resultKey(image, driver, sram, "SPRITE"));
+    expectSame(resultKey(image, driver, sram, "CACHE_HIT"),       resultKey(image, driver, sram, "CACHE_MISS"));
+    expectSame(resultKey(image, driver, sram, "IMAGE_LOAD"),      resultKey(image, driver, sram, "EXPORT_DITH"), true);
+}
+
+int main(int argc, char **argv) {
+
+    const char *dir      = argc > 1 ? argv[1] : "extras/test_images";
+    const char *contains = argc > 2 && argv[2][0] ? argv[2] : nullptr;
+    const char *golden   = argc > 3 ? argv[3] : nullptr;
+
+    SdFat sd;
+    sd.begin(dir);
+    std::vector<std::string> images = nativeListBitmaps(dir, contains);
+    if (images.empty()) {
+        Serial.printf("No bitmaps found in %s\n", dir);
+        return 1;
+    }
+
+    //Boards are kept for the whole run - one per driver and framebuffer mode:
+    SIKTEC_EPD *boards[NATIVE_DRIVERS][2];
+    for (uint8_t driver = 0; driver < NATIVE_DRIVERS; driver++) {
+        for (uint8_t sram = 0; sram < 2; sram++) {
+            boards[driver][sram] = nativeCreateBoard(driver, sram);
+        }
+    }
+
+    for (size_t i = 0; i < images.size(); i++) {
+        SIKTEC_EPD_BITMAP bmp(&sd, images[i].c_str());
+        for (uint8_t driver = 0; driver < NATIVE_DRIVERS; driver++) {
+            for (uint8_t sram = 0; sram < 2; sram++) {
+                SIKTEC_EPD *epd = boards[driver][sram];
+                for (uint8_t f = 0; f <= (uint8_t)BITMAP_FILTER::DITHER_BWR; f++) {
+                    epd->clearBuffer();
+                    nativeResetStats();
+                    EPD_BITMAP_STATUS status = bmp.drawBitmap((BITMAP_FILTER)f, 0, 0, epd);
+                    printDraw(images[i].c_str(), driver, sram, native_filter_names[f], (int)status, epd);
+                }
+                runCases(&sd, images[i].c_str(), driver, sram, epd);
+            }
+        }
+    }
+    checkTwins(images);
+    if (golden) {
+        checkGolden(golden, contains == nullptr);
+    }
+    if (failures) {
+        Serial.printf("FAILED %u checks\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -1,7 +1,7 @@
 
 /******************************************************************************/
 // Created by: SIKTEC.
-// Release Version : 1.0.5
+// Release Version : 1.0.6
 // Creation Date: 2022-03-31
 // Copyright 2022, SIKTEC.
 /******************************************************************************/
@@ -10,6 +10,7 @@
 
 #include "SIKTEC_EPD.h"
 #include <stdlib.h>
+#include <SdFat.h>
 
 namespace SIKtec {
 
@@ -228,7 +229,7 @@ epd_sram_space_t SIKTEC_EPD::getFreeSramSpace(uint32_t assumeTotalSizeKib)  {
 
     if (!this->use_sram) return {0,0,0};
     uint32_t total = assumeTotalSizeKib << 10; // bits 
-    uint32_t bitsRemaining = total - ((uint32_t)this->buffer1_size * 8 + (uint32_t)this->buffer2_size * 8);
+    uint32_t bitsRemaining = total - ((uint32_t)this->buffer1_size * 8 + (uint32_t)this->buffer2_size * 8) - this->sram_reserved * 8;
     return {
         bitsRemaining >> 10, 
         bitsRemaining / 8, 
@@ -266,6 +267,37 @@ void SIKTEC_EPD::releaseSramArrayBuffer()  {
     }
 }
 
+/**
+ * @brief reserve bytes at the top of the extra SRAM space - long lived buffers 
+ * (a color LUT for example) that the array buffer and the sprite cache will not overwrite.
+ * NOTE: reservations are stacked - release them in the reverse order.
+ * 
+ * @param bytes the number of bytes to reserve
+ * @return uint16_t the address of the reserved space
+ * @return 0 -> mens can't reserve, not enough space or SRAM is not used
+ */
+uint16_t SIKTEC_EPD::reserveSramSpace(const uint32_t bytes)  {
+    if (this->use_sram && bytes) {
+        epd_sram_space_t space = this->getFreeSramSpace();
+        //The free space starts one byte after buffer2 - keep it:
+        if (space.bytes > bytes + 1) {
+            this->sram_reserved += bytes;
+            return space.address + (space.bytes - 1) - bytes;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief release the last reserved bytes at the top of the extra SRAM space
+ * 
+ * @param bytes the number of bytes reserved
+ * @return void
+ */
+void SIKTEC_EPD::releaseSramSpace(const uint32_t bytes)  {
+    this->sram_reserved = bytes < this->sram_reserved ? this->sram_reserved - bytes : 0;
+}
+
 /**
  * @brief get / read an element from the allocated EXTRA sram buffer.
  * 
@@ -278,8 +310,8 @@ void SIKTEC_EPD::releaseSramArrayBuffer()  {
  */
 bool SIKTEC_EPD::getSramArrayBufferElement(const uint16_t address, const uint16_t index, uint8_t *out, const uint16_t num)  {
     if (this->use_sram) {
-        for (uint16_t i = 0; i < num; ++i)
-            this->sram->read(address + index * this->ram_buffer_element_size, out, this->ram_buffer_element_size);
+        //Elements are contiguous - read them in a single transaction:
+        this->sram->read(address + index * this->ram_buffer_element_size, out, this->ram_buffer_element_size * num);
         return true;
     }
     return false;
@@ -297,8 +329,8 @@ bool SIKTEC_EPD::getSramArrayBufferElement(const uint16_t address, const uint16_
  */
 bool SIKTEC_EPD::setSramArrayBufferElement(const uint16_t address, const uint16_t index, uint8_t *in, const uint16_t num)  {
     if (this->use_sram) {
-        for (uint16_t i = 0; i < num; ++i)
-            this->sram->write(address + index * this->ram_buffer_element_size, in, this->ram_buffer_element_size);
+        //Elements are contiguous - write them in a single transaction:
+        this->sram->write(address + index * this->ram_buffer_element_size, in, this->ram_buffer_element_size * num);
         return true;
     }
     return false;
@@ -590,6 +622,191 @@ void SIKTEC_EPD::debugPixel(const int16_t x, const int16_t y) {
 }
 #endif
 
+/**
+ * @brief the raw (unrotated) framebuffer width - aligned to 8.
+ * 
+ * @return uint16_t
+ */
+uint16_t SIKTEC_EPD::rawWidth() {
+    return this->fixed8_width;
+}
+
+/**
+ * @brief the raw (unrotated) framebuffer height - aligned to 8.
+ * 
+ * @return uint16_t
+ */
+uint16_t SIKTEC_EPD::rawHeight() {
+    return this->fixed8_height;
+}
+
+/**
+ * @brief the size in bytes of a framebuffer plane.
+ * 
+ * @param plane the plane - black or color.
+ * @return uint32_t 0 if the plane is not used by this board.
+ */
+uint32_t SIKTEC_EPD::planeSize(epd_plane_t plane) {
+    if (plane == EPD_PLANE_BLACK) {
+        return this->buffer1_size;
+    }
+    return this->buffer2_size;
+}
+
+/**
+ * @brief whether the plane bits are stored inverted (1 is white).
+ * 
+ * @param plane the plane - black or color.
+ * @return bool
+ */
+bool SIKTEC_EPD::isPlaneInverted(epd_plane_t plane) {
+    return plane == EPD_PLANE_BLACK ? this->blackInverted : this->colorInverted;
+}
+
+/**
+ * @brief the framebuffer layers of an EPD color - bit 0 is black and bit 1 is color.
+ * 
+ * @param color the EPD color (EPD_WHITE, EPD_BLACK...).
+ * @return uint8_t
+ */
+uint8_t SIKTEC_EPD::colorLayers(const uint16_t color) {
+    return color < EPD_NUM_COLORS ? this->layer_colors[color] : 0;
+}
+
+/**
+ * @brief converts a screen coordinate (current rotation) to the raw framebuffer 
+ * coordinate - same as getPixelAddress without the bounds check.
+ * 
+ * @param x  screen x coordinate
+ * @param y  screen y coordinate
+ * @param rx raw x coordinate
+ * @param ry raw y coordinate
+ * @return void
+ */
+void SIKTEC_EPD::screenToRaw(const int16_t x, const int16_t y, int16_t &rx, int16_t &ry) {
+    rx = x;
+    ry = y;
+    switch (this->getRotation()) {
+        case 1:
+            EPD_swap(rx, ry);
+            rx = this->fixed8_width - rx - 1;
+            break;
+        case 2:
+            rx = this->fixed8_width - rx - 1;
+            ry = this->fixed8_height - ry - 1;
+            break;
+        case 3:
+            EPD_swap(rx, ry);
+            ry = this->fixed8_height - ry - 1;
+            break;
+    }
+}
+
+/**
+ * @brief converts a screen region (current rotation) to the raw framebuffer region
+ * that covers it - clipped to the screen and expanded to whole bytes vertically.
+ * 
+ * @param x top-left x coordinate
+ * @param y top-left y coordinate
+ * @param w width
+ * @param h height
+ * @return epd_raw_rect_t w or h are 0 if the region is out of the screen.
+ */
+epd_raw_rect_t SIKTEC_EPD::getRawRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+    //Clip to screen:
+    int16_t x2 = x + w > this->width()  ? this->width()  : x + w;
+    int16_t y2 = y + h > this->height() ? this->height() : y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x >= x2 || y >= y2) {
+        return { 0, 0, 0, 0 };
+    }
+    //Rotate the corners - same as getPixelAddress:
+    int16_t rx1, ry1, rx2, ry2;
+    this->screenToRaw(x, y, rx1, ry1);
+    this->screenToRaw(x2 - 1, y2 - 1, rx2, ry2);
+    if (rx1 > rx2) EPD_swap(rx1, rx2);
+    if (ry1 > ry2) EPD_swap(ry1, ry2);
+    uint16_t by1 = ry1 & ~0x7;
+    uint16_t by2 = (ry2 | 0x7) + 1;
+    return { 
+        (uint16_t)rx1, 
+        by1, 
+        (uint16_t)(rx2 - rx1 + 1), 
+        (uint16_t)(by2 - by1) 
+    };
+}
+
+/**
+ * @brief the plane byte offset of a raw (unrotated) coordinate.
+ * the bytes of a raw column are contiguous - top to bottom.
+ * 
+ * @param rx raw x coordinate
+ * @param ry raw y coordinate
+ * @return uint32_t
+ */
+uint32_t SIKTEC_EPD::getRawColumnOffset(const uint16_t rx, const uint16_t ry) {
+    return this->getPixelAddressOffset(rx, ry);
+}
+
+/**
+ * @brief reads a run of bytes from a framebuffer plane - a single SRAM transaction 
+ * or a copy from the RAM buffer.
+ * 
+ * @param plane  the plane - black or color.
+ * @param offset the plane byte offset.
+ * @param out    the buffer to read into.
+ * @param len    number of bytes.
+ * @return bool false if out of the plane.
+ */
+bool SIKTEC_EPD::readPlane(epd_plane_t plane, uint32_t offset, uint8_t *out, uint16_t len) {
+    if (offset + len > this->planeSize(plane)) {
+        return false;
+    }
+    if (this->use_sram) {
+        this->sram->read(
+            (plane == EPD_PLANE_BLACK ? this->blackbuffer_addr : this->colorbuffer_addr) + offset, 
+            out, len
+        );
+        return true;
+    }
+    uint8_t *buffer = plane == EPD_PLANE_BLACK ? this->black_buffer : this->color_buffer;
+    if (!buffer) {
+        return false;
+    }
+    memcpy(out, buffer + offset, len);
+    return true;
+}
+
+/**
+ * @brief writes a run of bytes to a framebuffer plane - a single SRAM transaction 
+ * or a copy to the RAM buffer.
+ * 
+ * @param plane  the plane - black or color.
+ * @param offset the plane byte offset.
+ * @param in     the buffer to write from.
+ * @param len    number of bytes.
+ * @return bool false if out of the plane.
+ */
+bool SIKTEC_EPD::writePlane(epd_plane_t plane, uint32_t offset, const uint8_t *in, uint16_t len) {
+    if (offset + len > this->planeSize(plane)) {
+        return false;
+    }
+    if (this->use_sram) {
+        this->sram->write(
+            (plane == EPD_PLANE_BLACK ? this->blackbuffer_addr : this->colorbuffer_addr) + offset, 
+            (uint8_t *)in, len
+        );
+        return true;
+    }
+    uint8_t *buffer = plane == EPD_PLANE_BLACK ? this->black_buffer : this->color_buffer;
+    if (!buffer) {
+        return false;
+    }
+    memcpy(buffer + offset, in, len);
+    return true;
+}
+
 /**
  * @brief transfer the data in the buffer to epd ram:
  * 
@@ -675,6 +892,49 @@ void SIKTEC_EPD::writeSRAMFramebufferToEPD(uint16_t SRAM_buffer_addr, uint32_t b
     this->_spi->enableCsToggle();
 }
 
+/**
+ * @brief stream file data to epd ram in small chunks - no framebuffer involved.
+ * the EPD is deselected while reading the SD so both can share the SPI bus.
+ * 
+ * @param file        the open file to read from (current position) - nullptr sends a blank plane
+ * @param size        the total bytes to stream
+ * @param EPDlocation the location of the ram on EPD to write to
+ * @param invertdata  should invert bytes? 
+ * 
+ * @returns bool false if the file ended before size bytes were streamed.
+ */
+bool SIKTEC_EPD::writeFileToEPD(FatFile *file, uint32_t size, uint8_t EPDlocation, bool invertdata) {
+
+    uint8_t chunk[SIKTEC_EPD_STREAM_BUFFER];
+    bool complete = true;
+    if (!file) {
+        memset(chunk, 0x00, sizeof(chunk));
+    }
+
+    //We want to control cs pin ourselfs so disable the lib auto toggling
+    this->_spi->disableCsToggle();
+    this->EPD_csLow();
+    this->writeRAMCommand(EPDlocation);
+    this->EPD_csHigh();
+
+    for (uint32_t done = 0; done < size; ) {
+        uint16_t len = size - done > SIKTEC_EPD_STREAM_BUFFER ? SIKTEC_EPD_STREAM_BUFFER : size - done;
+        if (file && file->read(chunk, len) != len) {
+            //Short file - blank the rest so the EPD RAM is fully written:
+            memset(chunk, 0x00, sizeof(chunk));
+            file = nullptr;
+            complete = false;
+        }
+        this->EPD_csLow();
+        this->EPD_data(chunk, len, invertdata);
+        this->EPD_csHigh();
+        done += len;
+    }
+
+    this->_spi->enableCsToggle();
+    return complete;
+}
+
 /**
  * @brief helper method to set Or reset init instructions and lut
  * 
@@ -799,6 +1059,52 @@ void SIKTEC_EPD::display(bool sleep) {
     }
 }
 
+/**
+ * @brief streams full screen plane data from a file directly to the EPD and refreshes.
+ * the framebuffer is not used - works on boards without the RAM / SRAM for one.
+ * the file holds (from its current position) the black plane and then the color plane
+ * - planeSize() bytes each in the framebuffer byte order with 1 as ink (.epd plane data).
+ * 
+ * @param file      an open file positioned at the black plane.
+ * @param has_color whether the file holds a color plane - if not the color plane is blank.
+ * @param sleep     powerdown after the refresh.
+ * 
+ * @returns bool false if the file is shorter than the planes.
+ */
+bool SIKTEC_EPD::displayFromFile(FatFile &file, bool has_color, bool sleep) {
+
+    //First wakeup display:
+    this->powerUp();
+
+    // Set X & Y ram address: 
+    this->setRAMAddress(0, 0);
+
+    bool complete = this->writeFileToEPD(&file, this->buffer1_size, this->blackbuffer_index, this->blackInverted);
+
+    if (this->buffer2_size != 0) {
+
+        // we have a second buffer - transfer it:
+        delay(10);
+
+        // Set X & Y ram address: 
+        this->setRAMAddress(0, 0);
+
+        complete = this->writeFileToEPD(
+            has_color && complete ? &file : nullptr, 
+            this->buffer2_size, 
+            this->colorbuffer_index, 
+            this->colorInverted
+        ) && complete;
+    }
+
+    this->update();
+
+    if (sleep) {
+        this->powerDown();
+    }
+    return complete;
+}
+
 /**
  * @brief Determine whether the black pixel data is the first or second buffer
  * 
@@ -808,6 +1114,7 @@ void SIKTEC_EPD::display(bool sleep) {
  * @returns void
 */
 void SIKTEC_EPD::setBlackBuffer(int8_t index, bool inverted) {
+    this->blackbuffer_index = index;
     if (index == 0) {
         if (this->use_sram) {
             this->blackbuffer_addr = this->buffer1_addr;
@@ -834,6 +1141,7 @@ void SIKTEC_EPD::setBlackBuffer(int8_t index, bool inverted) {
  * @returns void
 */
 void SIKTEC_EPD::setColorBuffer(int8_t index, bool inverted) {
+    this->colorbuffer_index = index;
     if (index == 0) {
         if (this->use_sram) {
             this->colorbuffer_addr = this->buffer1_addr;
@@ -1,6 +1,6 @@
 /******************************************************************************/
 // Created by: SIKTEC.
-// Release Version : 1.0.5
+// Release Version : 1.0.6
 // Creation Date: 2022-04-12
 // Copyright 2022, SIKTEC.
 // 
@@ -38,6 +38,11 @@
     -> Updated to match the latest changes in SIKTEC-SPI ver 1.0.2
 1.0.5
     -> Performance improvement and reliability
+1.0.6
+    -> Framebuffer plane access (bulk RAM / SRAM region reads and writes).
+    -> Stream full screen plane data from a file directly to the EPD (displayFromFile).
+    -> Screen to raw coordinates and color layers helpers (used by the sprite cache).
+    -> Reserved space at the top of the extra SRAM (reserveSramSpace / releaseSramSpace).
 *******************************************************************************/
 
 /**  @file SIKTEC_EPD.h */
@@ -77,6 +82,8 @@
 #include <Adafruit_GFX.h>
 #include <SIKTEC_SPI.h>
 
+class FatFile; // SdFat - only referenced by the file streaming methods
+
 //------------------------------------------------------------------------//
 // DEFAULT ADDRESSES AND CONSTANTS:
 //------------------------------------------------------------------------//
@@ -86,6 +93,10 @@
 #define EPD_CMD_SEQUENCE_WAIT       0xFF
 #define EPD_CMD_SEQUENCE_END        0xFE
 
+#ifndef SIKTEC_EPD_STREAM_BUFFER
+    #define SIKTEC_EPD_STREAM_BUFFER 64 // bytes read from the SD per chunk when streaming a file to the EPD
+#endif
+
 //NOTE: onboard SRAM is rated 20Mhz AND EPD Drivers 20Mhz also - That said 20Mhz is not reliable best is 18 - 19. 
 #if defined(ESP32) || defined(ARDUINO_AVR_MEGA) || defined(AVR_MEGA2560) || defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__) || defined(ARDUINO_SAM_DUE) || defined(SAM3X8E)
     // #define EPD_SRAM_SPEED              4000000L
@@ -153,6 +164,25 @@ typedef struct EPD_SRAM_Space {
     uint16_t    address;
 } epd_sram_space_t;
 
+/**
+ * @brief the framebuffer planes - black and color (red / gray).
+*/
+typedef enum {
+    EPD_PLANE_BLACK,
+    EPD_PLANE_COLOR
+} epd_plane_t;
+
+/**
+ * @brief a framebuffer region in raw (unrotated) coordinates.
+ * y and h are aligned to whole bytes - each column is a contiguous run of h / 8 bytes.
+*/
+typedef struct EPD_Raw_Rect {
+    uint16_t    x;
+    uint16_t    y;
+    uint16_t    w;
+    uint16_t    h;
+} epd_raw_rect_t;
+
 //------------------------------------------------------------------------//
 // SIKTEC_EPD
 //------------------------------------------------------------------------//
@@ -199,6 +229,7 @@ public:
 private:
 
     uint16_t ram_buffer_element_size = 1;
+    uint32_t sram_reserved = 0; ///< bytes reserved at the top of the free SRAM space
 
 public:
 
@@ -212,6 +243,10 @@ public:
 
     void releaseSramArrayBuffer();
 
+    uint16_t reserveSramSpace(const uint32_t bytes);
+
+    void releaseSramSpace(const uint32_t bytes);
+
     bool getSramArrayBufferElement(const uint16_t address, const uint16_t index, uint8_t *out, const uint16_t num = 1);
 
     bool setSramArrayBufferElement(const uint16_t address, const uint16_t index, uint8_t *in, const uint16_t num = 1);
@@ -238,6 +273,8 @@ protected:
     uint16_t buffer2_addr;          // The SRAM address offsets for the secondary buffer
     uint16_t colorbuffer_addr;      // The SRAM address offsets for the color buffer
     uint16_t blackbuffer_addr;      // The SRAM address offsets for the black buffer
+    uint8_t  colorbuffer_index = 1; // The EPD RAM location (0 or 1) of the color buffer
+    uint8_t  blackbuffer_index = 0; // The EPD RAM location (0 or 1) of the black buffer
 
     //------------------------------------------------------------------------//
     // SPI related:
@@ -299,6 +336,7 @@ public:
     void setBlackBuffer(int8_t index, bool inverted);
     void setColorBuffer(int8_t index, bool inverted);
     void display(bool sleep = false);
+    bool displayFromFile(FatFile &file, bool has_color = true, bool sleep = false);
     bool EPD_commandList(const uint8_t *init_code);
     void EPD_command(uint8_t c, const uint8_t *buf, uint16_t len);
     void EPD_command(uint8_t c);
@@ -315,6 +353,18 @@ public:
     #if SIKTEC_EPD_DEBUG
         void debugPixel(const int16_t x, const int16_t y);
     #endif
+    //Framebuffer planes:
+    uint16_t rawWidth();
+    uint16_t rawHeight();
+    uint32_t planeSize(epd_plane_t plane);
+    bool isPlaneInverted(epd_plane_t plane);
+    uint8_t colorLayers(const uint16_t color);
+    void screenToRaw(const int16_t x, const int16_t y, int16_t &rx, int16_t &ry);
+    epd_raw_rect_t getRawRect(int16_t x, int16_t y, int16_t w, int16_t h);
+    uint32_t getRawColumnOffset(const uint16_t rx, const uint16_t ry);
+    bool readPlane(epd_plane_t plane, uint32_t offset, uint8_t *out, uint16_t len);
+    bool writePlane(epd_plane_t plane, uint32_t offset, const uint8_t *in, uint16_t len);
+
     void _print_debug_byte(uint16_t addr, uint8_t value, bool new_line = false, Stream *SerialPort = &Serial);
     void _display_buffer(uint16_t from_addr, uint8_t cols, int length, Stream *SerialPort = &Serial);
 
@@ -326,6 +376,7 @@ protected:
     
     void writeRAMFramebufferToEPD(uint8_t *buffer, uint32_t buffer_size, uint8_t EPDlocation, bool invertdata = false);
     void writeSRAMFramebufferToEPD(uint16_t SRAM_buffer_addr, uint32_t buffer_size, uint8_t EPDlocation, bool invertdata = false);
+    bool writeFileToEPD(FatFile *file, uint32_t size, uint8_t EPDlocation, bool invertdata = false);
 
     //------------------------------------------------------------------------//
     // BOARD Implementations required:
@@ -388,6 +439,8 @@ protected:
 // INCLUDE Extensions: should be removed by the linker if not addressed.
 //-----------------------------------------------------------------------------------------//
 #include "bitmap/SIKTEC_EPD_BITMAP.h"
+#include "bitmap/SIKTEC_EPD_IMAGE.h"
+#include "bitmap/SIKTEC_EPD_SPRITE_CACHE.h"
 
 
 
@@ -1,6 +1,6 @@
 /******************************************************************************/
 // Created by: SIKTEC.
-// Release Version : 1.0.5
+// Release Version : 1.0.6
 // Creation Date: 2022-04-12
 // Copyright 2022, SIKTEC.
 /******************************************************************************/
@@ -8,11 +8,181 @@
 /**  @file SIKTEC_BITMAP_FILTERS.cpp */
 
 #include "SIKTEC_BITMAP_FILTERS.h"
+#include <SIKTEC_EPD.h>
 
 namespace SIKtec {
 
     bool BITMAP_DITHER_FILTER::FORCE_RAM_BUFFER = false;
 
+/**
+ * @brief Construct a new color LUT - cells per channel are 2^bits, the channels 
+ * bits are limited to the color mode depth (16x16x16 = 4KB, 32x64x32 = 64KB - 565 full resolution).
+ * RAM tables above BITMAP_COLOR_LUT_MAX_RAM are rejected by build (see fitsRam).
+ * 
+ * @param bits_r - red index bits
+ * @param bits_g - green index bits
+ * @param bits_b - blue index bits
+ */
+BITMAP_COLOR_LUT::BITMAP_COLOR_LUT(const uint8_t bits_r, const uint8_t bits_g, const uint8_t bits_b) {
+    const uint8_t depth[3] = {
+        (uint8_t)(BITMAP_RED_CH_MAX   == 255 ? 8 : 5), 
+        (uint8_t)(BITMAP_GREEN_CH_MAX == 255 ? 8 : 6), 
+        (uint8_t)(BITMAP_BLUE_CH_MAX  == 255 ? 8 : 5)
+    };
+    const uint8_t requested[3] = { bits_r, bits_g, bits_b };
+    for (uint8_t c = 0; c < 3; ++c) {
+        this->bits[c] = requested[c] < 1 ? 1 : (requested[c] > depth[c] ? depth[c] : requested[c]);
+        this->top[c]  = (1 << this->bits[c]) - 1;
+    }
+    this->invalidate();
+}
+
+/**
+ * @brief Destroy the color LUT - releases the RAM table or the SRAM reservation.
+ */
+BITMAP_COLOR_LUT::~BITMAP_COLOR_LUT() {
+    delete[] this->table;
+    if (this->epd != nullptr) {
+        this->epd->releaseSramSpace(this->size());
+    }
+}
+
+/**
+ * @brief the table size in bytes - one byte index per cell.
+ * @return uint32_t
+ */
+uint32_t BITMAP_COLOR_LUT::size() {
+    return (uint32_t)1 << (this->bits[0] + this->bits[1] + this->bits[2]);
+}
+
+/**
+ * @brief whether the table can be allocated in RAM - not above BITMAP_COLOR_LUT_MAX_RAM 
+ * and addressable by size_t (16 bit on AVR - new would truncate the size).
+ * @return bool
+ */
+bool BITMAP_COLOR_LUT::fitsRam() {
+    return this->size() <= (uint32_t)BITMAP_COLOR_LUT_MAX_RAM && this->size() <= (uint32_t)((size_t)-1);
+}
+
+/**
+ * @brief keep the table at the top of the board free SRAM space - lookups read 
+ * blocks of neighbour cells (cached). Should be called before the table is built 
+ * and before a sprite cache is created on the same board.
+ * 
+ * @param epd - the board
+ * @return bool - false when SRAM is not used or there is not enough space (the table stays in RAM)
+ */
+bool BITMAP_COLOR_LUT::useSram(SIKTEC_EPD *epd) {
+    if (this->epd != nullptr) {
+        return true;
+    }
+    uint16_t address = epd->reserveSramSpace(this->size());
+    if (address == 0) {
+        return false;
+    }
+    delete[] this->table;
+    this->table        = nullptr;
+    this->epd          = epd;
+    this->sram_address = address;
+    this->invalidate();
+    return true;
+}
+
+/**
+ * @brief builds the table from the filter color map - each cell holds the closest 
+ * color of the cell center value.
+ * 
+ * @param filter - the filter with the color map, metric and color mode 
+ * @param key - the filter color map key
+ * @return bool - false when the table could not be allocated, is too large for RAM (fitsRam) 
+ * or the map is too large (> 256 colors) - the filter keeps the color map scan.
+ */
+bool BITMAP_COLOR_LUT::build(BITMAP_FILTER_IMPLEMENTATION *filter, const uint32_t key) {
+    this->key   = key;
+    this->built = false;
+    if (filter->map_size == 0 || filter->map_size > 256) {
+        return false;
+    }
+    if (this->epd == nullptr && this->table == nullptr) {
+        if (!this->fitsRam()) {
+            return false;
+        }
+        this->table = new uint8_t[this->size()];
+        if (this->table == nullptr) {
+            return false;
+        }
+    }
+    const uint8_t depth[3] = {
+        (uint8_t)(filter->color_mode == BITMAP_COLOR_MODE::COLOR888 ? 8 : 5), 
+        (uint8_t)(filter->color_mode == BITMAP_COLOR_MODE::COLOR888 ? 8 : 6), 
+        (uint8_t)(filter->color_mode == BITMAP_COLOR_MODE::COLOR888 ? 8 : 5)
+    };
+    uint8_t half[3];
+    for (uint8_t c = 0; c < 3; ++c) {
+        this->shift[c] = depth[c] > this->bits[c] ? depth[c] - this->bits[c] : 0;
+        half[c] = (1 << this->shift[c]) >> 1;
+    }
+    //Blue cells are contiguous - SRAM tables are written a blue run at a time: 
+    uint8_t  run[BITMAP_COLOR_LUT_SRAM_BLOCK];
+    uint32_t index = 0;
+    for (uint16_t r = 0; r <= this->top[0]; ++r) {
+        for (uint16_t g = 0; g <= this->top[1]; ++g) {
+            for (uint16_t b = 0; b <= this->top[2]; ++b, ++index) {
+                uint8_t match = filter->closestColor(
+                    (r << this->shift[0]) + half[0], 
+                    (g << this->shift[1]) + half[1], 
+                    (b << this->shift[2]) + half[2]
+                );
+                if (this->table != nullptr) {
+                    this->table[index] = match;
+                    continue;
+                }
+                run[index % BITMAP_COLOR_LUT_SRAM_BLOCK] = match;
+                if (index % BITMAP_COLOR_LUT_SRAM_BLOCK == BITMAP_COLOR_LUT_SRAM_BLOCK - 1 || index == this->size() - 1) {
+                    uint16_t len = index % BITMAP_COLOR_LUT_SRAM_BLOCK + 1;
+                    this->epd->sram->write(this->sram_address + index + 1 - len, run, len);
+                }
+            }
+        }
+    }
+    for (uint8_t i = 0; i < BITMAP_COLOR_LUT_SRAM_BLOCKS; ++i) {
+        this->block_tag[i] = -1;
+    }
+    this->built = true;
+    this->builds++;
+    return true;
+}
+
+/**
+ * @brief forces a rebuild on the next use.
+ * @return void
+ */
+void BITMAP_COLOR_LUT::invalidate() {
+    this->key   = 0;
+    this->built = false;
+    for (uint8_t i = 0; i < BITMAP_COLOR_LUT_SRAM_BLOCKS; ++i) {
+        this->block_tag[i] = -1;
+    }
+}
+
+/**
+ * @brief reads a cell of the SRAM table through the cached blocks.
+ * 
+ * @param index - the cell index
+ * @return uint8_t - the color map index
+ */
+uint8_t BITMAP_COLOR_LUT::sramLookup(const uint32_t index) {
+    int32_t tag  = index / BITMAP_COLOR_LUT_SRAM_BLOCK;
+    uint8_t slot = tag % BITMAP_COLOR_LUT_SRAM_BLOCKS;
+    if (this->block_tag[slot] != tag) {
+        uint32_t start = (uint32_t)tag * BITMAP_COLOR_LUT_SRAM_BLOCK;
+        uint32_t len   = this->size() - start < BITMAP_COLOR_LUT_SRAM_BLOCK ? this->size() - start : BITMAP_COLOR_LUT_SRAM_BLOCK;
+        this->epd->sram->read(this->sram_address + start, this->block[slot], len);
+        this->block_tag[slot] = tag;
+    }
+    return this->block[slot][index % BITMAP_COLOR_LUT_SRAM_BLOCK];
+}
+
 #ifdef BITMAP_COLOR_RESULT_888 
 
 #else 
@@ -1,6 +1,6 @@
 /******************************************************************************/
 // Created by: SIKTEC.
-// Release Version : 1.0.5
+// Release Version : 1.0.6
 // Creation Date: 2022-04-12
 // Copyright 2022, SIKTEC.
 // 
@@ -88,6 +88,123 @@ inline float  sqrt2(const float x)
   return x*u.x*(1.5f - xhalf*u.x*u.x);// Newton step, repeating increases accuracy 
 }
 
+#ifndef BITMAP_COLOR_MAP_SOA_SIZE
+    #define BITMAP_COLOR_MAP_SOA_SIZE 16 // color map entries kept as channel arrays - larger maps are scanned in place
+#endif
+
+/**
+ * @brief The colorDistance metric 
+ */
+enum BITMAP_COLOR_METRIC : uint8_t {
+    EUCLIDEAN,  // squared distance of the color mode channels
+    WEIGHTED    // 2:4:3 (R:G:B) weighted squared distance of the channels at the same depth - closer to the eye
+};
+
+#ifndef BITMAP_COLOR_LUT_SRAM_BLOCK
+    #define BITMAP_COLOR_LUT_SRAM_BLOCK 16 // bytes of a cached SRAM table block - neighbour blue cells
+#endif
+#ifndef BITMAP_COLOR_LUT_SRAM_BLOCKS
+    #define BITMAP_COLOR_LUT_SRAM_BLOCKS 4 // cached SRAM table blocks (direct mapped)
+#endif
+#ifndef BITMAP_COLOR_LUT_MAX_RAM
+    #if defined(__AVR__) && defined(RAMEND) && RAMEND > 0x1FFF
+        #define BITMAP_COLOR_LUT_MAX_RAM 4096   // AVR with 8KB RAM (mega) - up to 4:4:4 bits
+    #elif defined(__AVR__)
+        #define BITMAP_COLOR_LUT_MAX_RAM 1024   // AVR with 2KB - 2.5KB RAM (uno, nano, leonardo) - up to 3:4:3 bits
+    #else
+        #define BITMAP_COLOR_LUT_MAX_RAM 65536  // 32 bit boards (ESP32, Due, native) - up to 5:6:5 bits (565 full resolution)
+    #endif
+#endif
+
+class BITMAP_FILTER_IMPLEMENTATION;
+class SIKTEC_EPD;
+
+/**
+ * @brief Color LUT - a 3D table of the closest color map index for every quantized RGB cell.
+ * Attached to filters with setColorLUT - built by setColorMap and shared by all the filters 
+ * using the same color map, metric and color mode (rebuilt only when those change).
+ * The table is kept in RAM or at the top of the free SRAM space (useSram).
+ * The table is 2^(bits_r + bits_g + bits_b) bytes - RAM tables larger than BITMAP_COLOR_LUT_MAX_RAM 
+ * (or size_t) are not built and the filters keep the color map scan:
+ *  - AVR 2KB - 2.5KB RAM (uno, nano, leonardo): 1KB (3:4:3) - larger tables only with useSram.
+ *  - AVR 8KB RAM (mega): 4KB (4:4:4).
+ *  - 32 bit boards (ESP32, Due): 64KB (5:6:5) - 888 mode tables above 5:6:5 require a larger cap.
+ * NOTE: call setColorMap again if the color map values are changed in place.
+ */
+class BITMAP_COLOR_LUT {
+
+    public:
+
+    uint32_t builds = 0; ///< number of table builds
+
+    BITMAP_COLOR_LUT(const uint8_t bits_r = 4, const uint8_t bits_g = 4, const uint8_t bits_b = 4);
+
+    ~BITMAP_COLOR_LUT();
+
+    bool useSram(SIKTEC_EPD *epd);
+
+    uint32_t size();
+
+    bool fitsRam();
+
+    bool build(BITMAP_FILTER_IMPLEMENTATION *filter, const uint32_t key);
+
+    void invalidate();
+
+    /**
+     * @brief whether the table holds the color map of this key.
+     * @param _key - the filter color map key
+     * @return bool
+     */
+    inline bool holds(const uint32_t _key) {
+        return this->built && this->key == _key;
+    }
+
+    /**
+     * @brief whether a build of this key was already done (or failed).
+     * @param _key - the filter color map key
+     * @return bool
+     */
+    inline bool tried(const uint32_t _key) {
+        return this->key == _key;
+    }
+
+    /**
+     * @brief returns the closest color index of the RGB cell.
+     * 
+     * @param R 
+     * @param G 
+     * @param B 
+     * @return uint8_t - the color map index
+     */
+    inline uint8_t lookup(const uint8_t R, const uint8_t G, const uint8_t B) {
+        uint8_t r = R >> this->shift[0];
+        uint8_t g = G >> this->shift[1];
+        uint8_t b = B >> this->shift[2];
+        r = r > this->top[0] ? this->top[0] : r;
+        g = g > this->top[1] ? this->top[1] : g;
+        b = b > this->top[2] ? this->top[2] : b;
+        uint32_t index = ((uint32_t)r << (this->bits[1] + this->bits[2])) | ((uint16_t)g << this->bits[2]) | b;
+        return this->table != nullptr ? this->table[index] : this->sramLookup(index);
+    }
+
+    protected:
+
+    uint8_t     bits[3];                ///< index bits per channel
+    uint8_t     shift[3]  = { 0, 0, 0 };///< channel value to cell shift - set by build
+    uint8_t     top[3];                 ///< the last cell per channel
+    uint8_t     *table    = nullptr;    ///< RAM table - nullptr when in SRAM or not built
+    SIKTEC_EPD  *epd      = nullptr;    ///< the board holding the SRAM table
+    uint16_t    sram_address = 0;       ///< SRAM table address
+    uint32_t    key       = 0;          ///< the key of the last build
+    bool        built     = false;      ///< the table holds the key color map
+    int32_t     block_tag[BITMAP_COLOR_LUT_SRAM_BLOCKS]; ///< cached SRAM block indexes - -1 when empty
+    uint8_t     block[BITMAP_COLOR_LUT_SRAM_BLOCKS][BITMAP_COLOR_LUT_SRAM_BLOCK]; ///< cached SRAM blocks
+
+    uint8_t sramLookup(const uint32_t index);
+
+};
+
 //BITMAP FILTER ABSTRACTION:
 class BITMAP_FILTER_IMPLEMENTATION {
     
@@ -96,9 +213,24 @@ class BITMAP_FILTER_IMPLEMENTATION {
     BITMAP_COLOR_MODE color_mode = bitmap_color_result; ///< the color mode we are operating at 
     colorBits_t (*color_map)[4] = nullptr; ///< color map 
     uint16_t    map_size = 0; ///< map size
+    bool        position_dependent = false; ///< the kernel result depends on the pixel position - see position()
+    int16_t     pos_x = 0; ///< the epd x of the next kernel call - set only for position dependent filters
+    int16_t     pos_y = 0; ///< the epd y of the next kernel call - set only for position dependent filters
     
     /**
-     * @brief Set the Color Map object
+     * @brief Set the position of the next kernel call - the draw paths call it for 
+     * position dependent filters only (palette tables and cached results are skipped for them).
+     * 
+     * @param x - the epd x of the pixel
+     * @param y - the epd y of the pixel
+     */
+    inline void position(const int16_t x, const int16_t y) {
+        this->pos_x = x;
+        this->pos_y = y;
+    }
+
+    /**
+     * @brief Set the Color Map object - the map channels are precomputed for colorDistance.
      * 
      * @param map - N length of 4 colorBits_t sized elements { R, G, B, EPD_COLOR }
      * @param size - The color map size
@@ -106,10 +238,33 @@ class BITMAP_FILTER_IMPLEMENTATION {
     inline  void setColorMap( colorBits_t (*map)[4],  const uint16_t size) {
         this->map_size = size;
         this->color_map = map;
+        this->prepareColorMap();
+    }
+
+    /**
+     * @brief Set the colorDistance metric
+     * 
+     * @param metric - EUCLIDEAN (default) or WEIGHTED
+     */
+    inline void setColorMetric(const BITMAP_COLOR_METRIC metric) {
+        this->color_metric = metric;
+        this->prepareColorMap();
     }
     
     /**
-     * @brief returns the index of the closest color
+     * @brief Attach a color LUT - colorDistance becomes a single table lookup.
+     * The table is built now (if a color map is set) and by the following setColorMap calls.
+     * 
+     * @param lut - the shared color LUT - nullptr to detach
+     */
+    inline void setColorLUT(BITMAP_COLOR_LUT *lut) {
+        this->color_lut = lut;
+        this->prepareColorMap();
+    }
+
+    /**
+     * @brief returns the index of the closest color - a color LUT lookup when attached and built, 
+     * otherwise the color map scan (closestColor).
      * 
      * @param R 
      * @param G 
@@ -117,74 +272,77 @@ class BITMAP_FILTER_IMPLEMENTATION {
      * @return uint16_t - the closest color index
      */
     inline uint16_t colorDistance(const uint8_t R, const uint8_t G, const uint8_t B) {
-        int16_t fit = 10000;
-        uint8_t index = 0;
-        int16_t dist;
-        int16_t dR;
-        int16_t dG;
-        int16_t dB;
-        for (uint16_t i = 0; i < this->map_size; ++i) {
-            dR = R - this->color_map[i][0];
-            dG = G - this->color_map[i][1];
-            dB = B - this->color_map[i][2];
-            //NOTE: shlomi implemented this one much faster then pow()...
-            dist = sqrt2(dR*dR + dG*dG + dB*dB);
-            // dist = sqrt(
-            //       pow(R - this->color_map[i][0], 2) 
-            //     + pow(G - this->color_map[i][1], 2)
-            //     + pow(B - this->color_map[i][2], 2)
-            // );
-            if (dist == 0) {
-                return i;
+        //The map was changed directly (not with setColorMap):
+        if (this->soa.map != this->color_map || this->soa.size != this->map_size) {
+            this->prepareColorMap();
+        }
+        if (this->color_lut != nullptr) {
+            //Shared tables are rebuilt when another color map was built into it:
+            if (!this->color_lut->tried(this->soa.key)) {
+                this->color_lut->build(this, this->soa.key);
             }
-            if (dist < fit) {
-                fit = dist;
-                index = i;
+            if (this->color_lut->holds(this->soa.key)) {
+                return this->color_lut->lookup(R, G, B);
             }
         }
-        return index;
+        return this->closestColor(R, G, B);
     }
-    inline uint16_t colorDistance(const uint16_t color) {
 
-        uint8_t R;
-        uint8_t G;
-        uint8_t B;
-        int16_t fit = 10000;
-        uint8_t index = 0;
-        int16_t dist;
-        int16_t dR;
-        int16_t dG;
-        int16_t dB;
-        if (this->color_mode == BITMAP_COLOR_MODE::COLOR888) {
-            R = color >> 16;
-            G = (color >> 8) & 0xFF;
-            B = color & 0xFF;
-        } else {
-            R = color >> 11;
-            G = (color >> 5) & 0x3F;
-            B = color & 0x1F;
+    /**
+     * @brief returns the index of the closest color - squared integer distances, the first 
+     * closest color wins and an exact match returns at once.
+     * 
+     * @param R 
+     * @param G 
+     * @param B 
+     * @return uint16_t - the closest color index
+     */
+    inline uint16_t closestColor(const uint8_t R, const uint8_t G, const uint8_t B) {
+        uint32_t fit   = 0xFFFFFFFF;
+        uint16_t index = 0;
+        uint32_t dist;
+        int16_t  dR;
+        int16_t  dG;
+        int16_t  dB;
+        if (this->map_size > BITMAP_COLOR_MAP_SOA_SIZE) {
+            for (uint16_t i = 0; i < this->map_size; ++i) {
+                dR = R - (int16_t)this->color_map[i][0];
+                dG = G - (int16_t)this->color_map[i][1];
+                dB = B - (int16_t)this->color_map[i][2];
+                dist = this->soa.weight[0] * (uint32_t)(dR * dR) + this->soa.weight[1] * (uint32_t)(dG * dG) + this->soa.weight[2] * (uint32_t)(dB * dB);
+                if (dist < fit) {
+                    if (dist == 0) 
+                        return i;
+                    fit   = dist;
+                    index = i;
+                }
+            }
+            return index;
         }
         for (uint16_t i = 0; i < this->map_size; ++i) {
-            dR = R - this->color_map[i][0];
-            dG = G - this->color_map[i][1];
-            dB = B - this->color_map[i][2];
-            //NOTE: shlomi implemented this one much faster pow()...
-            dist = sqrt2(dR*dR + dG*dG + dB*dB);
-            // dist = sqrt(
-            //       pow(R - this->color_map[i][0], 2) 
-            //     + pow(G - this->color_map[i][1], 2)
-            //     + pow(B - this->color_map[i][2], 2)
-            // );
-            if (dist == 0) {
-                return i;
-            }
+            dG   = G - this->soa.g[i];
+            dist = this->soa.weight[1] * (uint32_t)(dG * dG);
+            //Already farther than the best - skip the other channels:
+            if (dist >= fit) 
+                continue;
+            dR   = R - this->soa.r[i];
+            dB   = B - this->soa.b[i];
+            dist += this->soa.weight[0] * (uint32_t)(dR * dR) + this->soa.weight[2] * (uint32_t)(dB * dB);
             if (dist < fit) {
-                fit = dist;
+                if (dist == 0) 
+                    return i;
+                fit   = dist;
                 index = i;
             }
         }
         return index;
     }
+    inline uint16_t colorDistance(const uint16_t color) {
+        if (this->color_mode == BITMAP_COLOR_MODE::COLOR888) {
+            return this->colorDistance(color >> 16, (color >> 8) & 0xFF, color & 0xFF);
+        }
+        return this->colorDistance(color >> 11, (color >> 5) & 0x3F, color & 0x1F);
+    }
 
     /**
      * @brief called on all pixels - apply the filter logic here.
@@ -195,8 +353,66 @@ class BITMAP_FILTER_IMPLEMENTATION {
      * @return colorBits_t 
      */
     virtual colorBits_t kernel(const uint8_t R, const uint8_t G, const uint8_t B) = 0;
+
+    /** @brief virtual destructor - filters are deleted through the base pointer. */
+    virtual ~BITMAP_FILTER_IMPLEMENTATION() {}
     
     protected:
+
+    BITMAP_COLOR_METRIC color_metric = BITMAP_COLOR_METRIC::EUCLIDEAN; ///< colorDistance metric
+    BITMAP_COLOR_LUT    *color_lut   = nullptr; ///< attached color LUT
+
+    /**
+     * @brief the color map channels as arrays (structure of arrays) and the metric weights
+     */
+    struct {
+        colorBits_t (*map)[4] = nullptr;
+        uint16_t    size = 0;
+        uint32_t    key = 0;
+        uint8_t     weight[3] = { 1, 1, 1 };
+        uint8_t     r[BITMAP_COLOR_MAP_SOA_SIZE];
+        uint8_t     g[BITMAP_COLOR_MAP_SOA_SIZE];
+        uint8_t     b[BITMAP_COLOR_MAP_SOA_SIZE];
+    } soa;
+
+    /**
+     * @brief precomputes the color map channel arrays, the metric weights and the color map key - 
+     * and builds the attached color LUT when required.
+     * WEIGHTED in 565 - the 5 bit channels are doubled to the green depth (x4 weight).
+     * @return void
+     */
+    inline void prepareColorMap() {
+        this->soa.map  = this->color_map;
+        this->soa.size = this->map_size;
+        if (this->color_metric == BITMAP_COLOR_METRIC::WEIGHTED) {
+            bool depth = this->color_mode == BITMAP_COLOR_MODE::COLOR565;
+            this->soa.weight[0] = depth ? 2 * 4 : 2;
+            this->soa.weight[1] = 4;
+            this->soa.weight[2] = depth ? 3 * 4 : 3;
+        } else {
+            this->soa.weight[0] = 1;
+            this->soa.weight[1] = 1;
+            this->soa.weight[2] = 1;
+        }
+        for (uint16_t i = 0; i < this->map_size && i < BITMAP_COLOR_MAP_SOA_SIZE; ++i) {
+            this->soa.r[i] = this->color_map[i][0];
+            this->soa.g[i] = this->color_map[i][1];
+            this->soa.b[i] = this->color_map[i][2];
+        }
+        //FNV-1a of the map values, the metric and the color mode:
+        uint32_t key = 2166136261UL;
+        key = (key ^ this->map_size) * 16777619UL;
+        key = (key ^ ((uint16_t)this->color_metric << 8 | this->color_mode)) * 16777619UL;
+        for (uint16_t i = 0; i < this->map_size; ++i) {
+            for (uint8_t c = 0; c < 4; ++c) {
+                key = (key ^ (uint32_t)this->color_map[i][c]) * 16777619UL;
+            }
+        }
+        this->soa.key = key;
+        if (this->color_lut != nullptr && this->map_size && !this->color_lut->tried(key)) {
+            this->color_lut->build(this, key);
+        }
+    }
 };
 
 /**
@@ -449,6 +665,224 @@ class BitmapFilter_QUANT : public BITMAP_FILTER_IMPLEMENTATION {
     }
 };
 
+#ifndef BITMAP_FILTER_MEMO_SIZE
+    #define BITMAP_FILTER_MEMO_SIZE 256 // default memo entries - rounded down to a power of 2
+#endif
+
+/**
+ * @brief MEMO filter - caches the results of another filter kernel
+ * A direct-mapped cache keyed on the packed 565 / 888 color - flat images with few colors
+ * will skip most of the wrapped kernel calls. hits / misses can be used to size the cache.
+ * NOTE: call clear() if the wrapped filter color map or settings are changed.
+ */
+class BitmapFilter_MEMO : public BITMAP_FILTER_IMPLEMENTATION {
+
+    BITMAP_FILTER_IMPLEMENTATION *filter; ///< the wrapped filter
+    uint32_t    *keys    = nullptr;        ///< packed colors of the cached entries
+    colorBits_t *results = nullptr;        ///< cached kernel results
+    uint16_t    mask     = 0;              ///< size - 1
+    uint8_t     bits     = 0;              ///< log2 size used to fold the key
+
+    public:
+
+    uint32_t hits   = 0; ///< kernel calls served from the cache
+    uint32_t misses = 0; ///< kernel calls passed to the wrapped filter
+
+    /**
+     * @brief Construct a new BitmapFilter_MEMO object
+     * 
+     * @param _filter the filter to wrap
+     * @param _size   number of entries (8 - 4096) rounded down to a power of 2
+     */
+    inline BitmapFilter_MEMO(BITMAP_FILTER_IMPLEMENTATION *_filter, const uint16_t _size = BITMAP_FILTER_MEMO_SIZE) {
+        this->filter = _filter;
+        uint16_t size = 8;
+        this->bits = 3;
+        while (this->bits < 12 && (uint16_t)(size << 1) <= _size) {
+            size <<= 1;
+            this->bits++;
+        }
+        this->keys    = new uint32_t[size];
+        this->results = new colorBits_t[size];
+        this->mask    = size - 1;
+        this->position_dependent = _filter->position_dependent;
+        this->clear();
+    }
+
+    /**
+     * @brief Destroy the BitmapFilter_MEMO object - releases the cache (not the wrapped filter).
+     */
+    inline ~BitmapFilter_MEMO() {
+        delete[] this->keys;
+        delete[] this->results;
+    }
+
+    /**
+     * @brief invalidates all the cached entries and resets the counters.
+     * @return void
+     */
+    inline void clear() {
+        for (uint16_t i = 0; i <= this->mask; ++i) {
+            this->keys[i] = 0xFFFFFFFF; // never a valid packed color
+        }
+        this->hits   = 0;
+        this->misses = 0;
+    }
+
+    /**
+     * @brief the cache hit rate 
+     * @return uint8_t 0 - 100 percent
+     */
+    inline uint8_t hitRate() {
+        uint32_t total = this->hits + this->misses;
+        return total ? (uint8_t)(((uint64_t)this->hits * 100) / total) : 0;
+    }
+
+    /**
+     * @brief called on all pixels - returns the cached result or calls the wrapped kernel.
+     * @param R 
+     * @param G 
+     * @param B 
+     * @return colorBits_t 
+     */
+    inline colorBits_t kernel(const uint8_t R, const uint8_t G, const uint8_t B) {
+        //Position dependent results can't be cached - passed through:
+        if (this->position_dependent) {
+            this->filter->position(this->pos_x, this->pos_y);
+            return this->filter->kernel(R, G, B);
+        }
+        uint32_t key = this->color_mode == BITMAP_COLOR_MODE::COLOR888
+                        ? ((uint32_t)R << 16) | ((uint32_t)G << 8) | B
+                        : ((uint32_t)R << 11) | ((uint32_t)G << 5) | B;
+        uint16_t slot = (key ^ (key >> this->bits) ^ (key >> (this->bits * 2))) & this->mask;
+        if (this->keys[slot] == key) {
+            this->hits++;
+            return this->results[slot];
+        }
+        this->misses++;
+        this->keys[slot]    = key;
+        this->results[slot] = this->filter->kernel(R, G, B);
+        return this->results[slot];
+    }
+};
+
+/**
+ * @brief ORDERED filter threshold masks
+ */
+enum BITMAP_ORDERED_MASK : uint8_t {
+    BAYER_4X4,
+    BAYER_8X8,
+    BLUE_NOISE_16X16
+};
+
+static const uint8_t BITMAP_BAYER_4X4[16] = {
+     0,  8,  2, 10,
+    12,  4, 14,  6,
+     3, 11,  1,  9,
+    15,  7, 13,  5
+};
+
+static const uint8_t BITMAP_BAYER_8X8[64] = {
+     0, 32,  8, 40,  2, 34, 10, 42,
+    48, 16, 56, 24, 50, 18, 58, 26,
+    12, 44,  4, 36, 14, 46,  6, 38,
+    60, 28, 52, 20, 62, 30, 54, 22,
+     3, 35, 11, 43,  1, 33,  9, 41,
+    51, 19, 59, 27, 49, 17, 57, 25,
+    15, 47,  7, 39, 13, 45,  5, 37,
+    63, 31, 55, 23, 61, 29, 53, 21
+};
+
+/** @brief void and cluster (Ulichney) blue noise ranks - toroidal so it tiles without seams */
+static const uint8_t BITMAP_BLUE_NOISE_16X16[256] = {
+    203, 231, 121, 145, 174,  62, 136, 187, 157,  21, 130,  75,  12,  99,  17,  83,
+    160,  22,   0, 217,  87, 229,  11,  79,  50, 219, 240, 167, 204, 142,  53, 178,
+     93, 242,  68, 189,  44, 117, 165, 236, 101, 195,  30, 118,  45, 188, 253, 115,
+     42, 129, 169, 106, 247, 150,  19, 207, 125, 147,  63,  89, 214,   4,  70, 220,
+    151, 208,  80,  32, 197,  57,  73, 180,  40,   8, 176, 246, 154, 105, 138,  26,
+     61, 237,  13, 141, 221,  96, 133, 250, 109,  82, 225, 131,  35, 199, 233, 171,
+    112, 193,  51, 122, 162,   6, 230,  25, 213, 166, 192,  20,  55,  76,  92,  18,
+    222,  85, 175, 254,  39, 185,  90, 153,  48,  67,  98, 119, 161, 249, 183, 127,
+    158,   2, 102,  69, 205, 114,  58, 202, 139,   1, 241, 206, 144,  10, 211,  46,
+    245, 143, 232,  27, 148,  78, 239, 172, 124, 228,  86,  41, 177,  31, 104,  65,
+    186,  36, 198, 128, 215,   9,  23, 100,  33, 182, 156,  59, 113, 224, 134,  81,
+     15, 116,  60,  91, 164, 248, 135, 194,  74, 218,  14, 252,  72, 196, 235, 163,
+    209, 170, 226,  43, 107, 181,  54, 234,  47, 120, 103, 140, 173,   5,  49,  94,
+    251, 137,   7, 191,  71,  16, 152,  84, 168, 200,  28, 210,  88, 123, 149,  24,
+    108,  77, 155, 243, 212, 126, 111, 223,   3, 146, 244,  56,  38, 190, 216,  64,
+     34, 184,  52,  97,  29, 201,  37, 255,  95,  66, 179, 110, 227, 159, 238, 132
+};
+
+/**
+ * @brief ORDERED dither filter - stateless, no error buffer.
+ * Each pixel is offset by the tiled threshold mask (+- spread / 2 of every channel) and 
+ * mapped to the closest color of the color map - works with any map (BW, BWR, GRAY4).
+ * The mask is anchored to the epd coordinates so clipped and sprite draws tile seamlessly.
+ */
+class BitmapFilter_ORDERED : public BITMAP_FILTER_IMPLEMENTATION {
+
+    const uint8_t *mask = BITMAP_BAYER_4X4; ///< the threshold mask ranks
+    uint8_t  mask_bits  = 2;                ///< log2 of the mask side
+    uint16_t spread[3];                     ///< R, G, B offsets range
+
+    public:
+
+    /**
+     * @brief Construct a new BitmapFilter_ORDERED object
+     * 
+     * @param _mask   the threshold mask 
+     * @param _spread the offsets range 0 - 100 percent of the channel - the distance between 
+     *                the map levels (100 for BW / BWR, ~33 for 4 grays)
+     */
+    inline BitmapFilter_ORDERED(const BITMAP_ORDERED_MASK _mask = BITMAP_ORDERED_MASK::BAYER_8X8, const uint8_t _spread = 100) {
+        this->position_dependent = true;
+        switch (_mask) {
+            case BITMAP_ORDERED_MASK::BAYER_4X4: {
+                this->mask      = BITMAP_BAYER_4X4;
+                this->mask_bits = 2;
+            } break;
+            case BITMAP_ORDERED_MASK::BLUE_NOISE_16X16: {
+                this->mask      = BITMAP_BLUE_NOISE_16X16;
+                this->mask_bits = 4;
+            } break;
+            default: {
+                this->mask      = BITMAP_BAYER_8X8;
+                this->mask_bits = 3;
+            }
+        }
+        uint16_t percent = _spread > 100 ? 100 : _spread;
+        this->spread[0] = BITMAP_RED_CH_MAX   * percent / 100;
+        this->spread[1] = BITMAP_GREEN_CH_MAX * percent / 100;
+        this->spread[2] = BITMAP_BLUE_CH_MAX  * percent / 100;
+    }
+
+    /**
+     * @brief called on all pixels - offsets the color by the mask threshold at the pixel 
+     * position and returns the closest color defined in the color map.
+     * @param R 
+     * @param G 
+     * @param B 
+     * @return colorBits_t 
+     */
+    inline colorBits_t kernel(const uint8_t R, const uint8_t G, const uint8_t B) {
+        const uint8_t side  = (1 << this->mask_bits) - 1;
+        //Centered threshold - odd steps in (-cells, cells):
+        int32_t t       = (int32_t)this->mask[((this->pos_y & side) << this->mask_bits) | (this->pos_x & side)] * 2 + 1 
+                        - (1 << (this->mask_bits * 2));
+        int32_t range   = 1 << (this->mask_bits * 2 + 1);
+        int16_t r       = R + t * this->spread[0] / range;
+        int16_t g       = G + t * this->spread[1] / range;
+        int16_t b       = B + t * this->spread[2] / range;
+        r = r < 0 ? 0 : (r > BITMAP_RED_CH_MAX   ? BITMAP_RED_CH_MAX   : r);
+        g = g < 0 ? 0 : (g > BITMAP_GREEN_CH_MAX ? BITMAP_GREEN_CH_MAX : g);
+        b = b < 0 ? 0 : (b > BITMAP_BLUE_CH_MAX  ? BITMAP_BLUE_CH_MAX  : b);
+        uint16_t match = this->colorDistance(r, g, b);
+        #if SIKTEC_EPD_DEBUG_BITMAP_KERNELS_PIXELS
+            PRINT_DEBUG_BUFFER("RGB: %u,%u,%u Pos %d,%d Offset %ld Color %d \n", R, G, B, this->pos_x, this->pos_y, (long)t, this->color_map[match][3]);
+        #endif
+        return this->color_map[match][3];
+    }
+};
 
 #ifndef DITHER_WEIGHTS_VECTOR_FLOYD
     #define DITHER_WEIGHTS_VECTOR_FLOYD 7, 3, 5, 1
@@ -460,13 +894,303 @@ class BitmapFilter_QUANT : public BITMAP_FILTER_IMPLEMENTATION {
     #define DITHER_WEIGHTS_VECTOR_BALANCED 4, 4, 4, 4
 #endif
 
+#ifndef DITHER_ERROR_SHIFT
+    #define DITHER_ERROR_SHIFT 4 // the weights are sixteenths of the error - (error * weight) >> 4
+#endif
+#define DITHER_THRESHOLD_SHIFT 8 // the threshold fixed point - Q8.8
+
+#ifndef BITMAP_DITHER_SERPENTINE
+    #define BITMAP_DITHER_SERPENTINE 0 // default scan of the dither filters - 1 for serpentine (odd rows right to left)
+#endif
+#ifndef BITMAP_DITHER_COMPACT_ERRORS
+    #define BITMAP_DITHER_COMPACT_ERRORS 0 // default RAM error rows storage - 1 for int8 errors when the range permits
+#endif
+#ifndef BITMAP_DITHER_STRIP_WIDTH
+    #define BITMAP_DITHER_STRIP_WIDTH 0 // default dither strips width - 0 dithers the full width at once
+#endif
+
+#define DITHER_KERNEL_MAX_ROWS  3 // error rows of the largest kernels - the current row included
+#define DITHER_KERNEL_MAX_REACH 2 // columns a kernel reaches to the left / right of the pixel
+#define DITHER_KERNEL_COLUMNS   (DITHER_KERNEL_MAX_REACH * 2 + 1)
+#define DITHER_KERNEL_SHIFT     8 // the diffusion engine weights - weight * 256 / divisor
+#define DITHER_MAX_CHANNELS     3 // error channels per pixel - 1 for grey filters, 3 for RGB filters
+#define DITHER_COLOR_MAX_PALETTE 8 // colors of the color dither filters palette
+#define DITHER_COMPACT_MAX      127 // compact (int8) error rows limit - values are saturated to +-
+
+/**
+ * @brief error diffusion kernel descriptor.
+ * weights[row][dx + DITHER_KERNEL_MAX_REACH] - row 0 is the current row, only the
+ * columns right of the pixel are used in it. The error share is weight / divisor.
+ */
+typedef struct BitmapDitherKernel {
+    uint8_t rows;       ///< error rows used - 1 to DITHER_KERNEL_MAX_ROWS
+    uint8_t divisor;    ///< the weights denominator
+    uint8_t weights[DITHER_KERNEL_MAX_ROWS][DITHER_KERNEL_COLUMNS];
+} bitmap_dither_kernel_t;
+
+/**
+ * @brief the classic error diffusion kernels.
+ * https://tannerhelland.com/2012/12/28/dithering-eleven-algorithms-source-code.html
+ * Atkinson diffuses only 6/8 of the error - by design.
+ */
+static const bitmap_dither_kernel_t DITHER_KERNEL_FLOYD = { 2, 16, {
+    { 0, 0, 0, 7, 0 },
+    { 0, 3, 5, 1, 0 }
+}};
+static const bitmap_dither_kernel_t DITHER_KERNEL_JARVIS = { 3, 48, {
+    { 0, 0, 0, 7, 5 },
+    { 3, 5, 7, 5, 3 },
+    { 1, 3, 5, 3, 1 }
+}};
+static const bitmap_dither_kernel_t DITHER_KERNEL_STUCKI = { 3, 42, {
+    { 0, 0, 0, 8, 4 },
+    { 2, 4, 8, 4, 2 },
+    { 1, 2, 4, 2, 1 }
+}};
+static const bitmap_dither_kernel_t DITHER_KERNEL_BURKES = { 2, 32, {
+    { 0, 0, 0, 8, 4 },
+    { 2, 4, 8, 4, 2 }
+}};
+static const bitmap_dither_kernel_t DITHER_KERNEL_SIERRA = { 3, 32, {
+    { 0, 0, 0, 5, 3 },
+    { 2, 4, 5, 4, 2 },
+    { 0, 2, 3, 2, 0 }
+}};
+static const bitmap_dither_kernel_t DITHER_KERNEL_SIERRA_TWO_ROW = { 2, 16, {
+    { 0, 0, 0, 4, 3 },
+    { 1, 2, 3, 2, 1 }
+}};
+static const bitmap_dither_kernel_t DITHER_KERNEL_SIERRA_LITE = { 2, 4, {
+    { 0, 0, 0, 2, 0 },
+    { 0, 1, 1, 0, 0 }
+}};
+static const bitmap_dither_kernel_t DITHER_KERNEL_ATKINSON = { 3, 8, {
+    { 0, 0, 0, 1, 1 },
+    { 0, 1, 1, 1, 0 },
+    { 0, 0, 1, 0, 0 }
+}};
+
+/**
+ * @brief DITHER filters base - integer error diffusion.
+ * The error is distributed with weight * error >> DITHER_ERROR_SHIFT (rounded) and the 
+ * threshold is kept as a Q8.8 fixed point - no float math per pixel so the results are 
+ * identical on every platform.
+ */
 class BITMAP_DITHER_FILTER : public BITMAP_FILTER_IMPLEMENTATION {
 
     public:
+
     static  bool FORCE_RAM_BUFFER;
+    uint8_t error_channels = 1; ///< error values diffused per pixel - 1 grey, 3 RGB (see channels())
     virtual colorBits_t kernel(const uint8_t R, const uint8_t G, const uint8_t B) = 0;
-    virtual void setWeightVector(const uint8_t right, const uint8_t down_left, const uint8_t down, const uint8_t down_right) = 0;
-    virtual void dither(int16_t pixels[5]) = 0;
+
+    /**
+     * @brief quantize a grey value to the closest panel level.
+     * 
+     * @param value the grey value with the diffused error added
+     * @param color returns the panel color to draw
+     * @return int16_t the grey value of the selected level - the error is value minus it
+     */
+    virtual int16_t quantize(const int16_t value, int16_t &color) = 0;
+
+    /**
+     * @brief splits a kernel result to its error channels - used when error_channels > 1.
+     * 
+     * @param pixel  the kernel result
+     * @param values returns the channel values
+     * @return void
+     */
+    virtual void channels(const colorBits_t pixel, int16_t values[DITHER_MAX_CHANNELS]) {
+        values[0] = (int16_t)pixel;
+    }
+
+    /**
+     * @brief quantize the channel values to the closest panel color - used when error_channels > 1.
+     * 
+     * @param values the channel values with the diffused error added - returns the channels error
+     * @param color  returns the panel color to draw
+     * @return void
+     */
+    virtual void quantizeChannels(int16_t values[DITHER_MAX_CHANNELS], int16_t &color) {
+        values[0] -= this->quantize(values[0], color);
+    }
+
+    /**
+     * @brief distributes the current pixel to the surronding pixels - the weight vector shape.
+     * 
+     * @param pixels the pixels [current, right, bottom left, bottom, bottom right]
+     */
+    virtual void dither(int16_t pixels[5]) {
+        int16_t color;
+        int16_t err = pixels[0] - this->quantize(pixels[0], color);
+        pixels[0] = color; // The selected color
+        this->diffuse(pixels, err);
+    }
+
+    /**
+     * @brief Set the Weight Vector object - sixteenths of the error (see DITHER_ERROR_SHIFT).
+     * 
+     * @param right 
+     * @param down_left 
+     * @param down 
+     * @param down_right 
+     * @return void
+     */
+    virtual void setWeightVector(const uint8_t right, const uint8_t down_left, const uint8_t down, const uint8_t down_right) {
+        this->weights[0] = right;
+        this->weights[1] = down_left;
+        this->weights[2] = down;
+        this->weights[3] = down_right;
+    }
+
+    /**
+     * @brief Set the error diffusion kernel - drawBitmapDithered uses it instead of the weight vector.
+     * 
+     * @param _kernel one of the DITHER_KERNEL_* descriptors - nullptr restores the weight vector
+     * @return void
+     */
+    inline void setKernel(const bitmap_dither_kernel_t *_kernel) {
+        this->diffusion = _kernel;
+    }
+
+    /**
+     * @brief Set the scan order - serpentine dithers the odd rows from right to left 
+     * (mirrored kernel) which breaks the directional artifacts of a left to right scan.
+     * 
+     * @param _serpentine true for serpentine scanning
+     * @return void
+     */
+    inline void setSerpentine(const bool _serpentine) {
+        this->serpentine = _serpentine;
+    }
+    inline bool getSerpentine() const {
+        return this->serpentine;
+    }
+
+    /**
+     * @brief Set the strips width - drawBitmapDithered dithers wider bitmaps in vertical strips 
+     * so the error rows buffer is sized to the strip and not to the bitmap width. The error 
+     * that leaves a strip is carried to the next one (no visible seams) - the bitmap rows 
+     * are read once per strip.
+     * 
+     * @param _width the strip width in pixels - 0 dithers the full width at once
+     * @return void
+     */
+    inline void setStripWidth(const uint16_t _width) {
+        this->strip_width = _width;
+    }
+    inline uint16_t getStripWidth() const {
+        return this->strip_width;
+    }
+
+    /**
+     * @brief Set the compact error rows - the RAM error rows are stored as int8 (half the memory) 
+     * when the filter values range permits it (see valueBound) - 565 grey filters whose pixels 
+     * stay within the quantize levels (threshold <= 1). Otherwise (or in SRAM) the int16 rows are used.
+     * 
+     * @param _compact true for int8 error rows
+     * @return void
+     */
+    inline void setCompactErrors(const bool _compact) {
+        this->compact_errors = _compact;
+    }
+    inline bool getCompactErrors() const {
+        return this->compact_errors;
+    }
+
+    /**
+     * @brief the largest magnitude of a diffused value (pixel + error) - 0 when it's not bounded.
+     * 
+     * @return int16_t
+     */
+    virtual int16_t valueBound() const {
+        return 0;
+    }
+
+    /**
+     * @brief the diffusion kernel in use - the weight vector as a Floyd Steinberg shaped kernel
+     * when none was set.
+     * 
+     * @return bitmap_dither_kernel_t
+     */
+    inline bitmap_dither_kernel_t getKernel() const {
+        if (this->diffusion != nullptr) {
+            return *this->diffusion;
+        }
+        bitmap_dither_kernel_t vector = { 2, 1 << DITHER_ERROR_SHIFT, {
+            { 0, 0, 0, this->weights[0], 0 },
+            { 0, this->weights[1], this->weights[2], this->weights[3], 0 }
+        }};
+        return vector;
+    }
+
+    protected:
+
+    const bitmap_dither_kernel_t *diffusion = nullptr; ///< the diffusion kernel - nullptr uses the weights vector
+    bool     serpentine  = BITMAP_DITHER_SERPENTINE;  ///< odd rows are dithered right to left
+    uint16_t strip_width = BITMAP_DITHER_STRIP_WIDTH; ///< dither strips width - 0 for full width
+    bool     compact_errors = BITMAP_DITHER_COMPACT_ERRORS; ///< int8 RAM error rows when the range permits
+
+    uint16_t threshold = 1 << DITHER_THRESHOLD_SHIFT; ///< grey scale multiplier - Q8.8 fixed point
+
+    /** @brief weights vector for the error distribution */
+    uint8_t  weights[4] = { 
+        DITHER_WEIGHTS_VECTOR_FLOYD 
+    };
+
+    /**
+     * @brief the diffused values bound of a grey filter - the error stays within the levels span 
+     * as long as the pixels are within the quantize levels (0 to top_level). Brighter pixels 
+     * (a threshold above 1) add error on every pixel so it isn't bounded.
+     * 
+     * @param top_level the highest quantize level
+     * @return int16_t the bound - 0 when not bounded
+     */
+    inline int16_t greyBound(const int16_t top_level) const {
+        int16_t top_pixel = ((int32_t)(this->color_mode == BITMAP_COLOR_MODE::COLOR888 ? 255 : 41) * this->threshold) >> DITHER_THRESHOLD_SHIFT;
+        return top_pixel <= top_level ? top_level * 2 : 0;
+    }
+
+    /**
+     * @brief Set the threshold - converted once to fixed point.
+     * 
+     * @param _threshold the threshold 0.0 - 2.0
+     * @return void
+     */
+    inline void setThreshold(const float _threshold) {
+        this->threshold = _threshold > 0 ? (uint16_t)(_threshold * (1 << DITHER_THRESHOLD_SHIFT) + 0.5f) : 0;
+    }
+
+    /**
+     * @brief the pixel greyscale scaled by the threshold.
+     * @param R 
+     * @param G 
+     * @param B 
+     * @return colorBits_t 
+     */
+    inline colorBits_t greyscale(const uint8_t R, const uint8_t G, const uint8_t B) {
+        return ((uint32_t)(((uint16_t)R + G + B) / 3) * this->threshold) >> DITHER_THRESHOLD_SHIFT;
+    }
+
+    /**
+     * @brief distributes the quantization error to the surronding pixels.
+     * NOTE: relies on an arithmetic right shift of negative values (gcc on every supported board).
+     * 
+     * @param pixels the pixels [current, right, bottom left, bottom, bottom right]
+     * @param err    the quantization error of the current pixel
+     * @return void
+     */
+    inline void diffuse(int16_t pixels[5], const int16_t err) {
+        const int32_t half = 1 << (DITHER_ERROR_SHIFT - 1);
+        //Right:
+        pixels[1] += ((int32_t)this->weights[0] * err + half) >> DITHER_ERROR_SHIFT;
+        //BOTTOM LEFT:
+        pixels[2] += ((int32_t)this->weights[1] * err + half) >> DITHER_ERROR_SHIFT;
+        //BOTTOM:
+        pixels[3] += ((int32_t)this->weights[2] * err + half) >> DITHER_ERROR_SHIFT;
+        //BOTTOM RIGHT:
+        pixels[4] += ((int32_t)this->weights[3] * err + half) >> DITHER_ERROR_SHIFT;
+    }
 };
 
 /**
@@ -476,16 +1200,10 @@ class BitmapFilter_DITHER_BW : public BITMAP_DITHER_FILTER {
 
     private:
 
-    float    threshold;             ///< threshold value for B & W
     int16_t  level = 128;           ///< greyscale mid 
     uint16_t color_black = 0x0000;  ///< black color 
     uint16_t color_white = 0xFFFF;  ///< white color 
 
-    /** @brief weights vector for the error distribution */
-    uint8_t  weights[4] = { 
-        DITHER_WEIGHTS_VECTOR_FLOYD 
-    };
-
     public:
     
     /**
@@ -496,7 +1214,7 @@ class BitmapFilter_DITHER_BW : public BITMAP_DITHER_FILTER {
      * @param _threshold   the threshold color 0.0 - 2.0 
      */
     inline BitmapFilter_DITHER_BW(const uint16_t _color_black, const uint16_t _color_white, const float _threshold = 1) {
-        this->threshold = _threshold;
+        this->setThreshold(_threshold);
         this->color_black = _color_black;
         this->color_white = _color_white;
         if (this->color_mode == BITMAP_COLOR_MODE::COLOR888) {
@@ -506,22 +1224,6 @@ class BitmapFilter_DITHER_BW : public BITMAP_DITHER_FILTER {
         }
     }
 
-    /**
-     * @brief Set the Weight Vector object
-     * 
-     * @param right 
-     * @param down_left 
-     * @param down 
-     * @param down_right 
-     * @return void
-     */
-    inline  void setWeightVector(const uint8_t right, const uint8_t down_left, const uint8_t down, const uint8_t down_right) {
-        this->weights[0] = right;
-        this->weights[1] = down_left;
-        this->weights[2] = down;
-        this->weights[3] = down_right;
-    }
-
     /**
      * @brief called on all pixels - returns the pixel greyscale.
      * @param R 
@@ -530,44 +1232,31 @@ class BitmapFilter_DITHER_BW : public BITMAP_DITHER_FILTER {
      * @return colorBits_t 
      */
     inline colorBits_t kernel(const uint8_t R, const uint8_t G, const uint8_t B) {
-        //Convert to grey:
-        return (((uint16_t)R + G + B) / 3) * this->threshold;
+        return this->greyscale(R, G, B);
     }
 
     /**
-     * @brief distributes the current pixel to the surronding pixels
+     * @brief quantize to black or white.
      * 
-     * @param pixels the pixels [current, right, bottom left, bottom, bottom right]
+     * @param value the grey value with the diffused error added
+     * @param color returns the panel color
+     * @return int16_t 
      */
-    inline void dither(int16_t pixels[5]) {
-        // for (int i = 0; i < 5; ++i)
-        //     Serial.printf("%d ", pixels[i]);
-        int16_t old_c = pixels[0];
-        int16_t new_c;
-        int16_t quant;
-        int16_t err;
-        float err_adj;
-        if (old_c > this->level) {
-            quant = this->color_mode == BITMAP_COLOR_MODE::COLOR888 ? 255 : 41; // white
-            new_c = this->color_white;
-        } else {
-            quant = 0; // black
-            new_c = this->color_black;
-        }
-        err = old_c - quant;
-        err_adj = (float)err / 16;
-        // Serial.printf(" => Errors(%d): %d - %.3f", this->level, err, err_adj);
-        // Serial.println();
-        //Current pixel:
-        pixels[0] = new_c; // The selected color
-        //Right:
-        pixels[1] = pixels[1] + this->weights[0] * err_adj;
-        //BOTTOM LEFT:
-        pixels[2] = pixels[2] + this->weights[1] * err_adj;
-        //BOTTOM:
-        pixels[3] = pixels[3] + this->weights[2] * err_adj;
-        //BOTTOM RIGHT:
-        pixels[4] = pixels[4] + this->weights[3] * err_adj;
+    inline int16_t quantize(const int16_t value, int16_t &color) {
+        if (value > this->level) {
+            color = this->color_white;
+            return this->color_mode == BITMAP_COLOR_MODE::COLOR888 ? 255 : 41; // white
+        }
+        color = this->color_black;
+        return 0; // black
+    }
+
+    /**
+     * @brief the diffused values bound - see greyBound.
+     * @return int16_t 
+     */
+    inline int16_t valueBound() const {
+        return this->greyBound(this->color_mode == BITMAP_COLOR_MODE::COLOR888 ? 255 : 41);
     }
 };
 
@@ -578,14 +1267,8 @@ class BitmapFilter_DITHER_GRAY4 : public BITMAP_DITHER_FILTER {
 
     private:
 
-    float    threshold;     ///< threshold value for B & W
     int16_t  level = 128;   ///< greyscale mid 
 
-    /** @brief weights vector for the error distribution */
-    uint8_t  weights[4] = { 
-        DITHER_WEIGHTS_VECTOR_FLOYD 
-    };
-
     public:
 
     /**
@@ -594,7 +1277,7 @@ class BitmapFilter_DITHER_GRAY4 : public BITMAP_DITHER_FILTER {
      * @param _threshold   the threshold color 0.0 - 2.0 
      */
     inline BitmapFilter_DITHER_GRAY4(const float _threshold = 1) {
-        this->threshold = _threshold;
+        this->setThreshold(_threshold);
         if (this->color_mode == BITMAP_COLOR_MODE::COLOR888) {
             this->level = 128;
         } else {
@@ -602,22 +1285,6 @@ class BitmapFilter_DITHER_GRAY4 : public BITMAP_DITHER_FILTER {
         }
     }
 
-    /**
-     * @brief Set the Weight Vector object
-     * 
-     * @param right 
-     * @param down_left 
-     * @param down 
-     * @param down_right 
-     * @return void
-     */
-    inline  void setWeightVector(const uint8_t right, const uint8_t down_left, const uint8_t down, const uint8_t down_right) {
-        this->weights[0] = right;
-        this->weights[1] = down_left;
-        this->weights[2] = down;
-        this->weights[3] = down_right;
-    }
-
     /**
      * @brief return closest color index based on its grey value
      * 
@@ -646,39 +1313,174 @@ class BitmapFilter_DITHER_GRAY4 : public BITMAP_DITHER_FILTER {
      * @return colorBits_t 
      */
     inline colorBits_t kernel(const uint8_t R, const uint8_t G, const uint8_t B) {
-        //Convert to grey:
-        return (((uint16_t)R + G + B) / 3) * this->threshold;
+        return this->greyscale(R, G, B);
     }
 
     /**
-     * @brief distributes the current pixel to the surronding pixels
+     * @brief quantize to the closest of the 4 grey levels.
      * 
-     * @param pixels the pixels [current, right, bottom left, bottom, bottom right]
+     * @param value the grey value with the diffused error added
+     * @param color returns the panel color
+     * @return int16_t 
      */
-    inline void dither(int16_t pixels[5]) {
-        //for (int i = 0; i < 5; ++i)
-        //    Serial.printf("%d ", pixels[i]);
-        int16_t  old_c   = pixels[0];
-        uint16_t quant_i = this->closest(old_c);
-        int16_t  new_c   = this->color_map[quant_i][3];
-        int16_t  err     = old_c - this->color_map[quant_i][0];
-        float    err_adj = (float)err / 16;
-        //Serial.printf(" => Errors(%d): %d - %.3f", this->level, err, err_adj);
-        //Serial.println();
-        //Current pixel:
-        pixels[0] = new_c; // The selected color
-        //Right:
-        pixels[1] = pixels[1] + this->weights[0] * err_adj;
-        //BOTTOM LEFT:
-        pixels[2] = pixels[2] + this->weights[1] * err_adj;
-        //BOTTOM:
-        pixels[3] = pixels[3] + this->weights[2] * err_adj;
-        //BOTTOM RIGHT:
-        pixels[4] = pixels[4] + this->weights[3] * err_adj;
+    inline int16_t quantize(const int16_t value, int16_t &color) {
+        uint16_t quant_i = this->closest(value);
+        color = this->color_map[quant_i][3]; // The selected color
+        return this->color_map[quant_i][0];
+    }
+
+    /**
+     * @brief the diffused values bound - see greyBound (the top level is the brightest map grey).
+     * @return int16_t 
+     */
+    inline int16_t valueBound() const {
+        int16_t top = 0;
+        for (uint16_t i = 0; i < this->map_size; ++i) {
+            top = (int16_t)this->color_map[i][0] > top ? this->color_map[i][0] : top;
+        }
+        return this->greyBound(top);
     }
 };
 
 
-}
+/**
+ * @brief DITHER 2D color filter - B & W & RED (tri-color panels).
+ * The RGB error is diffused per channel and every pixel is quantized to the closest color of 
+ * the color map { R, G, B, EPD_COLOR } - the panel palette (squared distance, no float math).
+ * The channels are handled as 0 - 255 in both color modes.
+ */
+class BitmapFilter_DITHER_BWR : public BITMAP_DITHER_FILTER {
+
+    private:
+
+    /**
+     * @brief the color map expanded to 0 - 255 channels
+     */
+    struct {
+        colorBits_t (*map)[4] = nullptr;
+        uint16_t    map_size = 0;   // the source map size - the expanded size is capped
+        uint8_t     size = 0;
+        int16_t     rgb[DITHER_COLOR_MAX_PALETTE][3];
+    } palette;
+
+    /**
+     * @brief expands the color map channels - once per color map.
+     * @return void
+     */
+    inline void expandPalette() {
+        this->palette.map      = this->color_map;
+        this->palette.map_size = this->map_size;
+        this->palette.size     = this->map_size < DITHER_COLOR_MAX_PALETTE ? this->map_size : DITHER_COLOR_MAX_PALETTE;
+        for (uint8_t i = 0; i < this->palette.size; ++i) {
+            if (this->color_mode == BITMAP_COLOR_MODE::COLOR888) {
+                this->palette.rgb[i][0] = this->color_map[i][0];
+                this->palette.rgb[i][1] = this->color_map[i][1];
+                this->palette.rgb[i][2] = this->color_map[i][2];
+            } else {
+                this->palette.rgb[i][0] = (this->color_map[i][0] << 3) | (this->color_map[i][0] >> 2);
+                this->palette.rgb[i][1] = (this->color_map[i][1] << 2) | (this->color_map[i][1] >> 4);
+                this->palette.rgb[i][2] = (this->color_map[i][2] << 3) | (this->color_map[i][2] >> 2);
+            }
+        }
+    }
+
+    public:
+
+    /**
+     * @brief Construct a new BitmapFilter_DITHER_BWR object
+     * 
+     * @param _threshold   the brightness multiplier 0.0 - 2.0 
+     */
+    inline BitmapFilter_DITHER_BWR(const float _threshold = 1) {
+        this->setThreshold(_threshold);
+        this->error_channels = 3;
+    }
+
+    /**
+     * @brief called on all pixels - returns the pixel color (packed in the color mode).
+     * @param R 
+     * @param G 
+     * @param B 
+     * @return colorBits_t 
+     */
+    inline colorBits_t kernel(const uint8_t R, const uint8_t G, const uint8_t B) {
+        if (this->color_mode == BITMAP_COLOR_MODE::COLOR888) {
+            return ((uint32_t)R << 16) | ((uint32_t)G << 8) | B;
+        }
+        return ((colorBits_t)R << 11) | ((colorBits_t)G << 5) | B;
+    }
+
+    /**
+     * @brief splits the packed pixel color to 0 - 255 channels scaled by the threshold.
+     * 
+     * @param pixel  the kernel result
+     * @param values returns R, G, B
+     * @return void
+     */
+    inline void channels(const colorBits_t pixel, int16_t values[DITHER_MAX_CHANNELS]) {
+        int16_t R, G, B;
+        if (this->color_mode == BITMAP_COLOR_MODE::COLOR888) {
+            R = (pixel >> 16) & 0xFF;
+            G = (pixel >> 8) & 0xFF;
+            B = pixel & 0xFF;
+        } else {
+            R = (pixel >> 11) & 0x1F;
+            G = (pixel >> 5) & 0x3F;
+            B = pixel & 0x1F;
+            R = (R << 3) | (R >> 2);
+            G = (G << 2) | (G >> 4);
+            B = (B << 3) | (B >> 2);
+        }
+        values[0] = ((int32_t)R * this->threshold) >> DITHER_THRESHOLD_SHIFT;
+        values[1] = ((int32_t)G * this->threshold) >> DITHER_THRESHOLD_SHIFT;
+        values[2] = ((int32_t)B * this->threshold) >> DITHER_THRESHOLD_SHIFT;
+    }
 
+    /**
+     * @brief quantize to the closest palette color - the values are clamped to 0 - 255 first 
+     * so saturated areas don't accumulate an unbounded error.
+     * 
+     * @param values R, G, B with the diffused error added - returns the channels error
+     * @param color  returns the panel color
+     * @return void
+     */
+    inline void quantizeChannels(int16_t values[DITHER_MAX_CHANNELS], int16_t &color) {
+        if (this->palette.map != this->color_map || this->palette.map_size != this->map_size) {
+            this->expandPalette();
+        }
+        for (uint8_t c = 0; c < 3; ++c) {
+            values[c] = values[c] < 0 ? 0 : (values[c] > 255 ? 255 : values[c]);
+        }
+        uint8_t  index = 0;
+        uint32_t fit   = 0xFFFFFFFF;
+        for (uint8_t i = 0; i < this->palette.size; ++i) {
+            int32_t dR = values[0] - this->palette.rgb[i][0];
+            int32_t dG = values[1] - this->palette.rgb[i][1];
+            int32_t dB = values[2] - this->palette.rgb[i][2];
+            uint32_t dist = dR * dR + dG * dG + dB * dB;
+            if (dist < fit) {
+                fit   = dist;
+                index = i;
+            }
+        }
+        color = this->color_map[index][3];
+        for (uint8_t c = 0; c < 3; ++c) {
+            values[c] -= this->palette.rgb[index][c];
+        }
+    }
 
+    /**
+     * @brief quantize a grey value to black or white - the single channel (weight vector) API.
+     * 
+     * @param value the grey value with the diffused error added
+     * @param color returns the panel color
+     * @return int16_t 
+     */
+    inline int16_t quantize(const int16_t value, int16_t &color) {
+        int16_t values[DITHER_MAX_CHANNELS] = { value, value, value };
+        this->quantizeChannels(values, color);
+        return value - values[0];
+    }
+};
+
+}
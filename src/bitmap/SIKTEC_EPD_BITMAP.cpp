@@ -1,6 +1,6 @@
 /******************************************************************************/
 // Created by: SIKTEC.
-// Release Version : 1.0.5
+// Release Version : 1.0.6
 // Creation Date: 2022-04-12
 // Copyright 2022, SIKTEC.
 /******************************************************************************/
@@ -17,6 +17,13 @@
 
 namespace SIKtec {
 
+/**
+ * @brief lookup tables used to unpack palette indexes from 1 / 4 bpp packed bytes.
+ * the left most pixel is stored in the most significant bits.
+ */
+static const uint8_t BITMAP_1BPP_MASK[8]  = { 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01 };
+static const uint8_t BITMAP_4BPP_SHIFT[2] = { 4, 0 };
+
 /**
  * @brief extern definition from SIKTEC_EPD for debugging.
  */
@@ -37,7 +44,7 @@ SIKTEC_EPD_BITMAP::SIKTEC_EPD_BITMAP(SdFat * sd, FatFile &_file, uint16_t filena
     this->exists = _file.isFile();
     this->file = _file;
     if (this->exists) {
-        this->definition = this->getBitmapDefinition(true);
+        this->loadDefinition();
         #if SIKTEC_EPD_DEBUG_BITMAP
             this->debug_bitmapDefinition();
         #endif
@@ -59,9 +66,8 @@ SIKTEC_EPD_BITMAP::SIKTEC_EPD_BITMAP(SdFat * sd, const char * imageName) {
     size_t nameSize = strlen(imageName) + 1;
     this->name = new char[nameSize];
     strcpy(this->name, imageName);
-    this->exists = this->sd->exists(imageName);
+    this->exists = this->loadDefinition();
     if (this->exists) {
-        this->definition = this->getBitmapDefinition(true);
         #if SIKTEC_EPD_DEBUG_BITMAP
             this->debug_bitmapDefinition();
         #endif
@@ -79,7 +85,236 @@ SIKTEC_EPD_BITMAP::SIKTEC_EPD_BITMAP(SdFat * sd, const char * imageName) {
 SIKTEC_EPD_BITMAP::~SIKTEC_EPD_BITMAP() {
     //Release name and allocated palette array:
     delete[] this->name;
-    delete[] this->definition.palette;
+    this->endSpriteSession();
+    this->releaseDefinition();
+}
+
+bool SIKTEC_EPD_BITMAP::CACHE_KEEP_OPEN = false;
+uint32_t SIKTEC_EPD_BITMAP::cache_hits   = 0;
+uint32_t SIKTEC_EPD_BITMAP::cache_misses = 0;
+
+#if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+
+/**
+ * @brief The definitions cache - shared by all the instances.
+ */
+static bmp_def_cache_entry_t definition_cache[SIKTEC_EPD_BITMAP_DEF_CACHE];
+static uint32_t definition_cache_tick = 0;
+
+/**
+ * @brief returns the cache entry of a file name or nullptr.
+ * 
+ * @param path the file name.
+ * @return bmp_def_cache_entry_t*
+ */
+static bmp_def_cache_entry_t *findDefinitionCache(const char *path) {
+    for (uint8_t i = 0; i < SIKTEC_EPD_BITMAP_DEF_CACHE; i++) {
+        if (definition_cache[i].path && strcmp(definition_cache[i].path, path) == 0) {
+            return &definition_cache[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief detaches an entry from its key - no more hits, the handle is closed.
+ * Unused entries are freed, used ones are freed by the last instance releasing them.
+ * 
+ * @param entry the cache entry.
+ */
+static void detachDefinitionCache(bmp_def_cache_entry_t *entry) {
+    delete[] entry->path;
+    entry->path = nullptr;
+    if (entry->file.isOpen()) {
+        entry->file.close();
+    }
+    if (entry->refs == 0) {
+        SIKTEC_EPD_BITMAP::freeBitmapDefinition(entry->definition);
+    }
+}
+
+#endif
+
+/**
+ * @brief releases all the cached definitions that are not in use and closes the kept handles.
+ * Definitions still used by instances are freed when the last of them is released.
+ */
+void SIKTEC_EPD_BITMAP::clearDefinitionCache() {
+    #if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+        for (uint8_t i = 0; i < SIKTEC_EPD_BITMAP_DEF_CACHE; i++) {
+            if (definition_cache[i].path) {
+                detachDefinitionCache(&definition_cache[i]);
+            }
+        }
+    #endif
+}
+
+/**
+ * @brief loads the bitmap definition - served from the definitions cache when the 
+ * file size and last write stamp did not change since it was parsed.
+ * The file identity (name hash, size, last write stamp) is kept - see spriteKey.
+ * 
+ * @return bool true if the file could be opened.
+ */
+bool SIKTEC_EPD_BITMAP::loadDefinition() {
+    #if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+        bmp_def_cache_entry_t *entry = findDefinitionCache(this->name);
+    #endif
+    bool closeAfter = !this->file.isOpen();
+    if (closeAfter) {
+        #if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+            if (entry && entry->file.isOpen()) {
+                this->file = entry->file;
+            } else 
+        #endif
+        if (!this->file.open(this->name, O_RDONLY)) {
+            return false;
+        }
+    }
+    dir_t dir;
+    this->file.dirEntry(&dir);
+    uint32_t modified = ((uint32_t)dir.lastWriteDate << 16) | dir.lastWriteTime;
+    this->file_size     = dir.fileSize;
+    this->file_modified = modified;
+    #if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+        if (entry && entry->size == dir.fileSize && entry->modified == modified) {
+            this->definition = entry->definition;
+            this->cached = entry;
+            entry->refs++;
+            entry->last_used = ++definition_cache_tick;
+            SIKTEC_EPD_BITMAP::cache_hits++;
+        } else {
+            this->definition = this->getBitmapDefinition(true);
+            this->storeDefinition(entry, dir.fileSize, modified);
+            SIKTEC_EPD_BITMAP::cache_misses++;
+        }
+    #else
+        this->definition = this->getBitmapDefinition(true);
+    #endif
+    if (closeAfter) {
+        this->file.close();
+    }
+    return true;
+}
+
+/**
+ * @brief the sprite cache key of a sprite of this bitmap - the file identity (FNV-1a hash 
+ * of the name, size and last write stamp as loaded) so instances re-created at the same 
+ * address or for a changed file never match the sprites of another file.
+ * 
+ * @param filter        the filter the sprite is decoded with.
+ * @param sprite_index  the sprite index.
+ * @return epd_sprite_key_t
+ */
+epd_sprite_key_t SIKTEC_EPD_BITMAP::spriteKey(const void *filter, uint16_t sprite_index) {
+    epd_sprite_key_t key;
+    key.source = 2166136261UL;
+    for (const char *c = this->name; *c; ++c) {
+        key.source = (key.source ^ (uint8_t)*c) * 16777619UL;
+    }
+    key.size     = this->file_size;
+    key.modified = this->file_modified;
+    key.filter   = filter;
+    key.index    = sprite_index;
+    return key;
+}
+
+/**
+ * @brief stores the freshly parsed definition in the definitions cache.
+ * Takes a free slot or evicts the least recently used unreferenced one - if all 
+ * the slots are in use the definition stays owned by this instance.
+ * 
+ * @param stale     the outdated entry of the same file or nullptr.
+ * @param size      the file size.
+ * @param modified  the file last write stamp.
+ */
+void SIKTEC_EPD_BITMAP::storeDefinition(bmp_def_cache_entry_t *stale, const uint32_t size, const uint32_t modified) {
+    #if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+        if (stale) {
+            detachDefinitionCache(stale);
+        }
+        if (this->definition.status != EPD_BITMAP_STATUS::VALID) {
+            return;
+        }
+        bmp_def_cache_entry_t *slot = nullptr;
+        for (uint8_t i = 0; i < SIKTEC_EPD_BITMAP_DEF_CACHE; i++) {
+            bmp_def_cache_entry_t *entry = &definition_cache[i];
+            if (entry->refs) continue;
+            if (!entry->path) { 
+                slot = entry; 
+                break; 
+            }
+            if (!slot || entry->last_used < slot->last_used) {
+                slot = entry;
+            }
+        }
+        if (!slot) {
+            return;
+        }
+        if (slot->path) {
+            detachDefinitionCache(slot);
+        }
+        slot->path = new char[strlen(this->name) + 1];
+        strcpy(slot->path, this->name);
+        slot->size       = size;
+        slot->modified   = modified;
+        slot->definition = this->definition;
+        slot->refs       = 1;
+        slot->last_used  = ++definition_cache_tick;
+        if (SIKTEC_EPD_BITMAP::CACHE_KEEP_OPEN) {
+            slot->file = this->file;
+        }
+        this->cached = slot;
+    #endif
+}
+
+/**
+ * @brief releases the definition - drops the cache entry reference or frees 
+ * the palette and bitfields tables owned by this instance.
+ */
+void SIKTEC_EPD_BITMAP::releaseDefinition() {
+    #if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+        if (this->cached) {
+            if (--this->cached->refs == 0 && !this->cached->path) {
+                SIKTEC_EPD_BITMAP::freeBitmapDefinition(this->cached->definition);
+            }
+            this->cached = nullptr;
+            this->definition = bmp_def_t();
+            return;
+        }
+    #endif
+    SIKTEC_EPD_BITMAP::freeBitmapDefinition(this->definition);
+}
+
+/**
+ * @brief releases the palette and the bitfields decode tables of a definition 
+ * returned by getBitmapDefinition(true) - the definition is reset.
+ * 
+ * @param def the definition to release.
+ */
+void SIKTEC_EPD_BITMAP::freeBitmapDefinition(bmp_def_t &def) {
+    delete[] def.palette;
+    delete[] def.bitfields.scale[0];
+    def = bmp_def_t();
+}
+
+/**
+ * @brief opens the bitmap file for reading - copies the cached open handle 
+ * when available which skips the directory lookup.
+ * 
+ * @return bool true if the file is open.
+ */
+bool SIKTEC_EPD_BITMAP::openBitmapFile() {
+    if (this->file.isOpen()) {
+        return true;
+    }
+    #if SIKTEC_EPD_BITMAP_DEF_CACHE > 0
+        if (this->cached && this->cached->path && this->cached->file.isOpen()) {
+            this->file = this->cached->file;
+            return this->file.isOpen();
+        }
+    #endif
+    return this->file.open(this->name, O_RDONLY);
 }
 
 /**
@@ -198,6 +433,318 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmapSprite(
     );
 }
 
+/**
+ * @brief the sprite batch order - sheet rows in file order (bottom-up sheets start from 
+ * the last row) and then columns from left.
+ * 
+ * @param index     the sprite index.
+ * @param sprite    the sprite definition.
+ * @param flip      the sheet is stored bottom-up.
+ * @return uint32_t
+ */
+static uint32_t spriteOrderKey(const uint16_t index, const bmp_sprite_t &sprite, const bool flip) {
+    uint16_t row = index / sprite.columns;
+    return (uint32_t)(flip ? sprite.rows - 1 - row : row) * sprite.columns + index % sprite.columns;
+}
+
+/**
+ * @brief Opens a sprite session on the defined sprite sheet.
+ * The file stays open until endSpriteSession and the palette (1 - 8 bpp) is filtered once
+ * for all the session draws. The filter object must outlive the session - dithering 
+ * filters are not supported as the error can't be diffused across sprites.
+ * 
+ * @param filter    BITMAP_FILTER_IMPLEMENTATION - the filter object pointer.
+ * @return EPD_BITMAP_STATUS VALID when the session is open.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::beginSpriteSession(BITMAP_FILTER_IMPLEMENTATION *filter) {
+    this->endSpriteSession();
+    if (!this->isValid()) {
+        return this->bitmapStatus();
+    }
+    if (!this->sprite.columns || !this->sprite.rows || !this->supportedCompression()) {
+        return EPD_BITMAP_STATUS::NOT_IMPLEMENTED;
+    }
+    if (!this->openBitmapFile()) {
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    }
+    this->session.filter = filter;
+    //Position dependent filters can't be applied to the palette:
+    if (this->definition.palette != nullptr && this->definition.palette_size
+        && (filter == nullptr || !filter->position_dependent)
+    ) {
+        this->session.palette_lut = new colorBits_t[this->definition.palette_size];
+        if (this->session.palette_lut != nullptr) {
+            for (uint16_t i = 0; i < (uint16_t)this->definition.palette_size; ++i) {
+                this->session.palette_lut[i] = this->pixelColorProccess(this->definition.palette[i], filter);
+            }
+            this->session.palette_lut_size = (uint16_t)this->definition.palette_size;
+        }
+    }
+    this->session.active = true;
+    return EPD_BITMAP_STATUS::VALID;
+}
+
+/**
+ * @brief Closes the sprite session - releases the file handle and the palette table.
+ * 
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::endSpriteSession() {
+    if (this->session.active && this->file.isOpen()) {
+        this->file.close();
+    }
+    delete[] this->session.palette_lut;
+    this->session = bmp_sprite_session_t();
+}
+
+/**
+ * @brief Draws a sprite through a decoded sprites cache.
+ * A miss decodes and filters the whole sprite once into packed planes (a temporary RAM 
+ * buffer of cache->entrySize bytes) and stores it - hits are byte level blits with no SD 
+ * access. Sprites that can't be cached (larger than the pool, no memory) are drawn directly.
+ * The cache key is the file identity (spriteKey - name, size and last write stamp), the filter 
+ * object, the sprite index and size - a changed file misses. The filter is keyed by address - call 
+ * cache->clear() when a cached filter settings or color map change.
+ * The sprite is drawn on the cache epd.
+ * 
+ * @param cache         SIKTEC_EPD_SPRITE_CACHE * the cache to use.
+ * @param filter        BITMAP_FILTER_IMPLEMENTATION - the filter object pointer.
+ * @param sprite_index  uint16_t the index of the sprite position.
+ * @param epd_x         int16_t the top-left X position on the EPD.
+ * @param epd_y         int16_t the top-left Y position on the EPD.
+ * @return EPD_BITMAP_STATUS - consider DONE as successfull.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawCachedSprite(
+    SIKTEC_EPD_SPRITE_CACHE *cache,
+    BITMAP_FILTER_IMPLEMENTATION *filter,
+    uint16_t        sprite_index,
+    int16_t         epd_x,
+    int16_t         epd_y
+) {
+    if (!this->isValid()) {
+        return this->bitmapStatus();
+    }
+    if (!this->sprite.columns || !this->sprite.rows || !this->supportedCompression()) {
+        return EPD_BITMAP_STATUS::NOT_IMPLEMENTED;
+    }
+    if (sprite_index >= this->sprite.columns * this->sprite.rows) {
+        return EPD_BITMAP_STATUS::DONE;
+    }
+
+    //Cached - blit (position dependent filters are never cached - the result depends on the position):
+    SIKTEC_EPD       *epd = cache->target();
+    epd_sprite_key_t key  = this->spriteKey(filter, sprite_index);
+    bool    cacheable = filter == nullptr || !filter->position_dependent;
+    int16_t slot = cacheable ? cache->find(key, this->sprite.width, this->sprite.height) : -1;
+    if (slot >= 0) {
+        cache->blit(slot, epd_x, epd_y);
+        return EPD_BITMAP_STATUS::DONE;
+    }
+
+    if (!this->openBitmapFile()) {
+        this->definition.status = EPD_BITMAP_STATUS::ERROR_READ_FILE;
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    }
+    uint16_t w      = this->sprite.width;
+    uint16_t h      = this->sprite.height;
+    uint16_t row    = sprite_index / this->sprite.columns;
+    uint16_t col    = sprite_index % this->sprite.columns;
+    bmp_read_definition_t bmp_read = this->prepareBitmapReadDefinition(row * h, col * w, w, h);
+
+    uint32_t size   = cache->entrySize(w, h);
+    uint8_t *planes = cacheable && size && size <= cache->capacity() ? new uint8_t[size] : nullptr;
+    if (planes == nullptr) {
+        //Not cacheable - draw directly (drawPixel clips negative positions):
+        this->proccessPixelArray((uint32_t)epd_x, (uint32_t)epd_y, bmp_read, epd, filter);
+        this->file.close();
+        return EPD_BITMAP_STATUS::DONE;
+    }
+    memset(planes, 0, size);
+
+    //Decode the whole sprite - the blit clips:
+    bmp_row_reader_t reader;
+    this->beginRowReader(reader, bmp_read, true);
+    this->prefilterPalette(reader, bmp_read, filter);
+    uint16_t line = reader.row_direction > 0 ? 0 : h - 1;
+    while (this->nextBitmapRow(reader, bmp_read)) {
+        for (uint16_t px = 0; px < w; ++px) {
+            colorBits_t pixel1 = this->readRowPixel(reader, filter);
+            cache->plot(planes, w, h, px, line, epd->colorLayers(pixel1));
+        }
+        line += reader.row_direction;
+    }
+    this->endRowReader(reader);
+    this->file.close();
+
+    slot = cache->store(key, w, h, planes);
+    delete[] planes;
+    cache->blit(slot, epd_x, epd_y);
+    return EPD_BITMAP_STATUS::DONE;
+}
+
+/**
+ * @brief Draws a single sprite within the open sprite session.
+ * 
+ * @param sprite_index  uint16_t the index of the sprite position.
+ * @param epd_x         int16_t the top-left X position on the EPD.
+ * @param epd_y         int16_t the top-left Y position on the EPD.
+ * @param epd           SIKTEC_EPD * the pointer to the epd to draw on.
+ * @return EPD_BITMAP_STATUS 
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawSprite(uint16_t sprite_index, int16_t epd_x, int16_t epd_y, SIKTEC_EPD *epd) {
+    bmp_sprite_draw_t draw;
+    draw.index = sprite_index;
+    draw.x     = epd_x;
+    draw.y     = epd_y;
+    return this->drawSprites(&draw, 1, epd);
+}
+
+/**
+ * @brief Draws a batch of sprites within the open sprite session.
+ * The batch is ordered by sheet row (in file order) - each sheet row is read once and every 
+ * sprite that uses it is drawn from the same decoded pixels. The sheet columns between the 
+ * requested sprites are skipped without decoding. RLE sheets are drawn sprite by sprite.
+ * Overlapping sprites are drawn in sheet order - not in the batch order.
+ * 
+ * @param sprites   const bmp_sprite_draw_t * the sprites to draw.
+ * @param count     uint16_t number of sprites.
+ * @param epd       SIKTEC_EPD * the pointer to the epd to draw on.
+ * @return EPD_BITMAP_STATUS - consider DONE as successfull.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawSprites(const bmp_sprite_draw_t *sprites, uint16_t count, SIKTEC_EPD *epd) {
+
+    if (!this->session.active) {
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    }
+    //Another draw call may have closed the handle:
+    if (!this->openBitmapFile()) {
+        this->definition.status = EPD_BITMAP_STATUS::ERROR_READ_FILE;
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    }
+
+    //Order the batch by sheet row in file order and then by column:
+    uint16_t *order = new uint16_t[count];
+    if (order == nullptr) {
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    }
+    uint16_t valid = 0;
+    uint16_t total = this->sprite.columns * this->sprite.rows;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (sprites[i].index >= total) continue;
+        uint32_t key = spriteOrderKey(sprites[i].index, this->sprite, this->definition.flip);
+        //Insertion sort - batches are small:
+        uint16_t j = valid++;
+        while (j > 0 && spriteOrderKey(sprites[order[j - 1]].index, this->sprite, this->definition.flip) > key) {
+            order[j] = order[j - 1];
+            --j;
+        }
+        order[j] = i;
+    }
+
+    //Draw sheet row by sheet row:
+    for (uint16_t first = 0; first < valid; ) {
+        uint16_t row  = sprites[order[first]].index / this->sprite.columns;
+        uint16_t last = first + 1;
+        while (last < valid && sprites[order[last]].index / this->sprite.columns == row) {
+            ++last;
+        }
+        this->drawSheetRow(sprites, order + first, last - first, epd);
+        first = last;
+    }
+
+    delete[] order;
+    return EPD_BITMAP_STATUS::DONE;
+}
+
+/**
+ * @brief draws the sprites of a single sheet row - the given order is sorted by column.
+ * The lines of the sheet row are read once over the span of the requested columns.
+ * 
+ * @param sprites   const bmp_sprite_draw_t * the batch.
+ * @param order     const uint16_t * the batch indexes of this sheet row sorted by column.
+ * @param count     uint16_t number of indexes.
+ * @param epd       SIKTEC_EPD * the pointer to the epd to draw on.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::drawSheetRow(const bmp_sprite_draw_t *sprites, const uint16_t *order, uint16_t count, SIKTEC_EPD *epd) {
+
+    uint16_t row        = sprites[order[0]].index / this->sprite.columns;
+    uint16_t first_col  = sprites[order[0]].index % this->sprite.columns;
+    uint16_t last_col   = sprites[order[count - 1]].index % this->sprite.columns;
+    uint32_t w          = this->sprite.width;
+    uint32_t h          = this->sprite.height;
+
+    //RLE streams can't skip and position dependent filters can't share a decoded pixel - draw sprite by sprite:
+    if (this->definition.info_header.compression == BMP_COMPRESSION::BI_RLE8
+        || this->definition.info_header.compression == BMP_COMPRESSION::BI_RLE4
+        || (this->session.filter != nullptr && this->session.filter->position_dependent)
+    ) {
+        for (uint16_t i = 0; i < count; ++i) {
+            const bmp_sprite_draw_t &draw = sprites[order[i]];
+            bmp_read_definition_t bmp_read = this->prepareBitmapReadDefinition(
+                row * h, (draw.index % this->sprite.columns) * w, w, h
+            );
+            this->proccessPixelArray(draw.x, draw.y, bmp_read, epd, this->session.filter);
+        }
+        return;
+    }
+
+    bmp_read_definition_t bmp_read = this->prepareBitmapReadDefinition(
+        row * h, first_col * w, (last_col - first_col + 1) * w, h
+    );
+    bmp_row_reader_t reader;
+    this->beginRowReader(reader, bmp_read, true);
+    reader.palette_lut      = this->session.palette_lut;
+    reader.palette_lut_size = this->session.palette_lut_size;
+
+    int16_t line = reader.row_direction > 0 ? 0 : (int16_t)h - 1;
+    while (this->nextBitmapRow(reader, bmp_read)) {
+        uint16_t i = 0;
+        for (uint16_t col = first_col; col <= last_col; ++col) {
+            //The batch indexes of this column:
+            uint16_t from = i;
+            while (i < count && sprites[order[i]].index % this->sprite.columns == col) {
+                ++i;
+            }
+            if (from == i) {
+                this->skipRowPixels(reader, w);
+                continue;
+            }
+            for (uint32_t px = 0; px < w; ++px) {
+                colorBits_t pixel1 = this->readRowPixel(reader, this->session.filter);
+                for (uint16_t k = from; k < i; ++k) {
+                    epd->drawPixel(sprites[order[k]].x + (int16_t)px, sprites[order[k]].y + line, pixel1);
+                }
+            }
+        }
+        line += reader.row_direction;
+    }
+    //The palette table is owned by the session:
+    reader.palette_lut      = nullptr;
+    reader.palette_lut_size = 0;
+    this->endRowReader(reader);
+}
+
+/**
+ * @brief skips pixels of the current row - no decoding or filtering.
+ * 
+ * @param reader - the reader state.
+ * @param pixels - number of pixels to skip.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::skipRowPixels(bmp_row_reader_t &reader, uint32_t pixels) {
+    if (this->definition.info_header.bpp < 8) {
+        for (uint32_t p = 0; p < pixels; ++p) {
+            this->readRowIndex(reader);
+        }
+        return;
+    }
+    uint32_t bytes = pixels * (this->definition.info_header.bpp / 8);
+    for (uint32_t b = 0; b < bytes; ++b) {
+        this->readRowByte(reader);
+    }
+}
+
 /**
  * @brief draws a bitmap directly to the epd applying a filter.
  * 
@@ -230,6 +777,26 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
         return this->drawBitmapDithered(&DITHERBW_filter, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch, reloadDefinition);
     }
 
+    //If we want a dither filter BWR (tri-color panels):
+    if (builtin_filters == BITMAP_FILTER::DITHER_BWR) {
+        #ifdef BITMAP_COLOR_RESULT_888 
+        uint16_t colormap_dither_bwr[3][4] = {
+            { 0,     0,      0,      EPD_BLACK   },
+            { 255,   255,    255,    EPD_WHITE   },
+            { 255,   0,      0,      EPD_RED     }
+        };
+    #else 
+        uint16_t colormap_dither_bwr[3][4] = {
+            { 0,     0,      0,      EPD_BLACK   },
+            { 31,    63,     31,     EPD_WHITE   },
+            { 31,    0,      0,      EPD_RED     }
+        };
+    #endif 
+        BitmapFilter_DITHER_BWR DITHERBWR_filter(1.15);
+        DITHERBWR_filter.setColorMap(colormap_dither_bwr, 3);
+        return this->drawBitmapDithered(&DITHERBWR_filter, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch, reloadDefinition);
+    }
+
     //If we want a dither filter GRAY4:
     if (builtin_filters == BITMAP_FILTER::DITHER_GRAY4) {
         #ifdef BITMAP_COLOR_RESULT_888 
@@ -264,6 +831,11 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
             {85,    85,     85,     EPD_LIGHT   },
             {255,   0,      0,      EPD_RED     }
         };
+        uint16_t colormap_bwr[3][4] = {
+            {0,     0,      0,      EPD_BLACK   },
+            {255,   255,    255,    EPD_WHITE   },
+            {255,   0,      0,      EPD_RED     }
+        };
     #else 
         uint16_t colormap[5][4] = {
             {0,     0,      0,      EPD_BLACK   },
@@ -272,6 +844,11 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
             {20,    40,     20,     EPD_LIGHT   },
             {31,    0,      0,      EPD_RED     }
         };
+        uint16_t colormap_bwr[3][4] = {
+            {0,     0,      0,      EPD_BLACK   },
+            {31,    63,     31,     EPD_WHITE   },
+            {31,    0,      0,      EPD_RED     }
+        };
     #endif 
 
     BITMAP_FILTER_IMPLEMENTATION *filter;
@@ -293,6 +870,18 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
             filter = new BitmapFilter_QUANT();
             filter->setColorMap(colormap, 5);
         } break;
+        case BITMAP_FILTER::ORDERED_BW: {
+            filter = new BitmapFilter_ORDERED(BITMAP_ORDERED_MASK::BAYER_8X8, 100);
+            filter->setColorMap(colormap, 2);
+        } break;
+        case BITMAP_FILTER::ORDERED_BWR: {
+            filter = new BitmapFilter_ORDERED(BITMAP_ORDERED_MASK::BAYER_8X8, 100);
+            filter->setColorMap(colormap_bwr, 3);
+        } break;
+        case BITMAP_FILTER::ORDERED_GRAY4: {
+            filter = new BitmapFilter_ORDERED(BITMAP_ORDERED_MASK::BAYER_8X8, 34);
+            filter->setColorMap(colormap, 4);
+        } break;
         default: {
             filter = new BitmapFilter_GRAY4(30);
             filter->setColorMap(colormap, 4);
@@ -344,9 +933,45 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
     bool reloadDefinition
 ) {
 
+    bmp_read_definition_t bmp_read;
+    EPD_BITMAP_STATUS status = this->beginDraw(bmp_read, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch, reloadDefinition);
+    if (status != EPD_BITMAP_STATUS::VALID) {
+        return status;
+    }
+    this->proccessPixelArray(
+        epd_x, epd_y, bmp_read, epd, filter
+    );
+
+    this->file.close();
+    return EPD_BITMAP_STATUS::DONE;
+}
+
+/**
+ * @brief clips the drawn region to the bitmap and the EPD, prepares the read definition 
+ * and opens the bitmap file - shared by the drawBitmap entry points.
+ * 
+ * @param bmp_read  the read definition to fill.
+ * @param epd_x     uint32_t the top-left X position on the EPD.
+ * @param epd_y     uint32_t the top-left Y position on the EPD.
+ * @param epd       SIKTEC_EPD * the pointer to the epd to draw on.
+ * @param bmp_sc    uint32_t the bitmap starting point X / Column (From Left).
+ * @param bmp_sr    uint32_t the bitmap starting point Y / Row (From Top).
+ * @param bmp_cw    uint32_t The width to draw (clip width) - 0 for full width.
+ * @param bmp_ch    uint32_t The width to draw (clip height) - 0 for full height.
+ * @param reloadDefinition bool whether to reload definition or not.
+ * @return EPD_BITMAP_STATUS VALID when the file is open and the rows can be drawn - otherwise the draw result.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::beginDraw(
+    bmp_read_definition_t &bmp_read,
+    uint32_t epd_x, uint32_t epd_y, SIKTEC_EPD *epd,
+    uint32_t bmp_sc, uint32_t bmp_sr, uint32_t bmp_cw, uint32_t bmp_ch, 
+    bool reloadDefinition
+) {
+
     //Reload the header? only if changes could have been done....
     if (reloadDefinition) {
-        this->definition = this->getBitmapDefinition(true);
+        this->releaseDefinition();
+        this->loadDefinition();
     }
 
     // Make sure we are ready to go:
@@ -361,7 +986,7 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
     //Open file:
     //NOTE: Shlomi removed this - its not necessary and can cause problems.
     //this->sd->chvol(); // set this card to be the current active volume.
-    if (!this->file.isOpen() && !this->file.open(this->name, O_RDONLY)) {
+    if (!this->openBitmapFile()) {
         this->definition.status = EPD_BITMAP_STATUS::ERROR_READ_FILE;
         return EPD_BITMAP_STATUS::ERROR_READ_FILE;
     }
@@ -386,39 +1011,31 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
     if (loadHeight + epd_y > (unsigned)epd->height()) 
         loadHeight = epd->height() - epd_y;
 
-    //starting row and columns:
-    uint32_t bmpStartRow = this->height() - bmp_sr - loadHeight;
+    //starting row and columns (from top - the read definition maps them to the stored order):
+    uint32_t bmpStartRow = bmp_sr;
     uint32_t bmpStartCol  = bmp_sc;
 
     //the read definition for the bitmap file:
-    bmp_read_definition_t bmp_read = this->prepareBitmapReadDefinition(bmpStartRow, bmpStartCol, loadWidth, loadHeight);
+    bmp_read = this->prepareBitmapReadDefinition(bmpStartRow, bmpStartCol, loadWidth, loadHeight);
 
-    //FUTURE: add support for other compressions atleast RLE....
-    if ( this->definition.info_header.compression == 0 ) {
-        //Simple uncompressed bitmap:
-        this->proccessUncompressed(
-            epd_x, epd_y, bmp_read, epd, filter
-        );
-    } else if (   this->definition.info_header.compression == 3 
-                && (this->definition.info_header.bpp == 16 || this->definition.info_header.bpp == 32)
-    ) {
-        // Observed in GIMP Bitmaps -> bpp 16, 32 is marked compressed....
-        // Its a not:
-        this->proccessUncompressed(
-            epd_x, epd_y, bmp_read, epd, filter
-        );
-    } else {
+    //Uncompressed, bitfields and RLE pixel arrays are streamed by the row reader:
+    if (!this->supportedCompression()) {
         //Not supported:
         this->file.close();
         return EPD_BITMAP_STATUS::NOT_IMPLEMENTED; 
     }
-
-    this->file.close();
-    return EPD_BITMAP_STATUS::DONE;
+    return EPD_BITMAP_STATUS::VALID;
 }
 
 /**
  * @brief Draws the bitmap on the given EPD using a dithering filter.
+ * When the filter strip width is set (and narrower than the drawn width) the bitmap is 
+ * dithered in vertical strips - the error rows are sized to the strip and the rows are 
+ * read once per strip.
+ * NOTE: bottom-up RLE8 / RLE4 bitmaps are streamed in file order, so they are dithered from 
+ * the bottom row up (the error is diffused upwards). The result differs from the same image 
+ * stored uncompressed or top-down (dithered from the top row down) - use an uncompressed copy 
+ * when the outputs must match. Plain, clipped and scaled draws are identical.
  * 
  * @param filter    BITMAP_DITHER_FILTER - the dither filter object pointer.
  * @param epd_x     uint32_t the top-left X position on the EPD.
@@ -443,267 +1060,672 @@ EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmapDithered(
     bool reloadDefinition
 ) {
 
-    //Reload the header? only if changes could have been done....
-    if (reloadDefinition) {
-        this->definition = this->getBitmapDefinition(true);
+    //The clipped window - the strips read definitions are prepared from it:
+    bmp_read_definition_t clip;
+    EPD_BITMAP_STATUS status = this->beginDraw(clip, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch, reloadDefinition);
+    if (status != EPD_BITMAP_STATUS::VALID) {
+        return status;
+    }
+    uint32_t loadWidth   = clip.read_width;
+    uint32_t loadHeight  = clip.read_height;
+    uint32_t bmpStartRow = bmp_sr;
+    uint32_t bmpStartCol = clip.start_col;
+
+    //Strips - the error rows are sized to the strip and the edge error is carried between strips:
+    uint32_t stripWidth = filter->getStripWidth() && filter->getStripWidth() < loadWidth ? filter->getStripWidth() : loadWidth;
+    bool     strips     = stripWidth < loadWidth;
+
+    //Error rows ring - one row per kernel row:
+    bmp_diffusion_t diffusion;
+    if (!this->beginDiffusion(diffusion, filter, epd, (uint16_t)stripWidth, strips ? (uint16_t)loadHeight : 0)) {
+        this->file.close();
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
     }
 
-    // Make sure we are ready to go:
-    if (!this->isValid()) {
-        return this->bitmapStatus();
-    } 
+    for (uint32_t strip = 0; strip < loadWidth; strip += stripWidth) {
+        uint32_t width = loadWidth - strip < stripWidth ? loadWidth - strip : stripWidth;
+        bmp_read_definition_t bmp_read = this->prepareBitmapReadDefinition(bmpStartRow, bmpStartCol + strip, width, loadHeight);
+        this->resetDiffusion(diffusion, epd, (uint16_t)width, strip > 0, strip + width < loadWidth);
+
+        //Rows are streamed sequentially from the top of the clip window and dithered in a single pass:
+        //NOTE: bottom-up RLE streams can only be read in file order (bottom to top) - see the doc above.
+        bmp_row_reader_t reader;
+        this->beginRowReader(reader, bmp_read);
+        this->prefilterPalette(reader, bmp_read, filter);
+        int16_t epd_row = (int16_t)(reader.row_direction > 0 ? epd_y : epd_y + loadHeight - 1);
+        for (uint32_t row = 0; row < loadHeight && this->nextBitmapRow(reader, bmp_read); ++row) {
+            this->diffuseRow(diffusion, filter, epd, (int16_t)(epd_x + strip), epd_row, &reader);
+            #if SIKTEC_EPD_DEBUG_BITMAP_DITHER
+                PRINT_DEBUG_BUFFER("After Dither Row: %lu \n", (unsigned long)row);
+                this->printDitherBuffer(diffusion, epd);
+            #endif
+            epd_row += reader.row_direction; 
+        }
+        this->endRowReader(reader);
+    }
+
+    //Release:
+    this->endDiffusion(diffusion, epd);
+    
+    this->file.close();
+    return EPD_BITMAP_STATUS::DONE;
+}
+
+/**
+ * @brief Draws the whole bitmap downscaled to the given size applying a filter.
+ * Rows are streamed once in file order - the box filter accumulates the source rows of each 
+ * output row (O(output width) memory) and nearest neighbour skips the rows it doesn't sample.
+ * The filter runs once per output pixel. Upscaling is not supported - the size is clamped
+ * to the bitmap size.
+ * 
+ * @param filter        BITMAP_FILTER_IMPLEMENTATION - the filter object pointer.
+ * @param epd_x         uint32_t the top-left X position on the EPD.
+ * @param epd_y         uint32_t the top-left Y position on the EPD.
+ * @param epd           SIKTEC_EPD * the pointer to the epd to draw on.
+ * @param out_width     uint32_t the drawn width.
+ * @param out_height    uint32_t the drawn height - 0 keeps the aspect ratio.
+ * @param scale         BITMAP_SCALE the downscale method.
+ * @param reloadDefinition bool default False - whether to reload definition or not.
+ * @return EPD_BITMAP_STATUS  - consider DONE as successfull.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmapScaled(
+    BITMAP_FILTER_IMPLEMENTATION *filter,
+    uint32_t epd_x,
+    uint32_t epd_y,
+    SIKTEC_EPD *epd,
+    uint32_t out_width,
+    uint32_t out_height,
+    BITMAP_SCALE scale,
+    bool reloadDefinition
+) {
 
     //Early exit if we dont need to do anything:
     if (epd && ((epd_x >= (uint32_t)epd->width()) || (epd_y >= (uint32_t)epd->height()))) 
         return EPD_BITMAP_STATUS::DONE;
 
-    //Open file:
-    //NOTE: Shlomi removed this - its not necessary and can cause problems.
-    //this->sd->chvol(); // set this card to be the current active volume.
-    if (!this->file.isOpen() && !this->file.open(this->name, O_RDONLY)) {
-        this->definition.status = EPD_BITMAP_STATUS::ERROR_READ_FILE;
-        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    bmp_scaler_t scaler;
+    bmp_read_definition_t bmp_read;
+    EPD_BITMAP_STATUS status = this->beginScaledDraw(scaler, bmp_read, out_width, out_height, scale, reloadDefinition);
+    if (status != EPD_BITMAP_STATUS::VALID) {
+        return status;
     }
-    
-    //Shrink clip if it goes out of bmp bounds:
-    uint32_t bmpWidth = (bmp_cw && bmp_cw < (uint32_t)this->width()) ? bmp_cw : this->width();
-    if (bmpWidth + bmp_sc > (uint32_t)this->width()) {
-        bmpWidth -= bmpWidth + bmp_sc - this->width();
+
+    colorBits_t *line = new colorBits_t[scaler.out_width];
+    if (line == nullptr) {
+        this->endScaledDraw(scaler);
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
     }
-    uint32_t bmpHeight  = bmp_ch && bmp_ch < (uint32_t)this->height() ? bmp_ch : this->height();
-    if (bmpHeight + bmp_sr > (uint32_t)this->height()) {
-        bmpHeight -= bmpHeight + bmp_sr - this->height();
+    //Only the visible columns are filtered:
+    uint32_t visible = epd_x + scaler.out_width > (uint32_t)epd->width() ? epd->width() - epd_x : scaler.out_width;
+    bool positioned  = filter != nullptr && filter->position_dependent;
+
+    bmp_row_reader_t reader;
+    this->beginRowReader(reader, bmp_read, true);
+    int32_t out_row;
+    while ((out_row = this->scaleNextRow(reader, bmp_read, scaler, line)) >= 0) {
+        if (epd_y + out_row >= (uint32_t)epd->height()) 
+            continue;
+        for (uint32_t c = 0; c < visible; ++c) {
+            if (positioned) {
+                filter->position((int16_t)(epd_x + c), (int16_t)(epd_y + out_row));
+            }
+            epd->drawPixel((int16_t)(epd_x + c), (int16_t)(epd_y + out_row), this->pixelColorProccess(line[c], filter));
+        }
     }
+    this->endRowReader(reader);
 
-    uint32_t loadWidth  = bmpWidth;
-    uint32_t loadHeight = bmpHeight; 
-    
-    //Avoid drawing outside of epd boundaries:
-    if (loadWidth + epd_x > (unsigned)epd->width()) 
-        loadWidth = epd->width() - epd_x;
+    delete[] line;
+    this->endScaledDraw(scaler);
+    return EPD_BITMAP_STATUS::DONE;
+}
 
-    if (loadHeight + epd_y > (unsigned)epd->height()) 
-        loadHeight = epd->height() - epd_y;
+/**
+ * @brief Draws the whole bitmap downscaled to the given size using a dithering filter.
+ * The error is diffused over the output pixels - the same engine and kernel as drawBitmapDithered.
+ * The filter strip width is ignored - the output rows are dithered at full width.
+ * 
+ * @param filter        BITMAP_DITHER_FILTER - the dither filter object pointer.
+ * @param epd_x         uint32_t the top-left X position on the EPD.
+ * @param epd_y         uint32_t the top-left Y position on the EPD.
+ * @param epd           SIKTEC_EPD * the pointer to the epd to draw on.
+ * @param out_width     uint32_t the drawn width.
+ * @param out_height    uint32_t the drawn height - 0 keeps the aspect ratio.
+ * @param scale         BITMAP_SCALE the downscale method.
+ * @param reloadDefinition bool default False - whether to reload definition or not.
+ * @return EPD_BITMAP_STATUS  - consider DONE as successfull.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmapScaledDithered(
+    BITMAP_DITHER_FILTER *filter,
+    uint32_t epd_x,
+    uint32_t epd_y,
+    SIKTEC_EPD *epd,
+    uint32_t out_width,
+    uint32_t out_height,
+    BITMAP_SCALE scale,
+    bool reloadDefinition
+) {
 
-    //starting row and columns:
-    uint32_t bmpStartRow = this->height() - bmp_sr - loadHeight;
-    uint32_t bmpStartCol  = bmp_sc;
+    //Early exit if we dont need to do anything:
+    if (epd && ((epd_x >= (uint32_t)epd->width()) || (epd_y >= (uint32_t)epd->height()))) 
+        return EPD_BITMAP_STATUS::DONE;
 
-    //Early exit if not supported:
-    if (
-        (this->definition.info_header.compression != 0 &&  this->definition.info_header.compression != 3)
-        || (
-            this->definition.info_header.compression == 3 
-            && this->definition.info_header.bpp != 16
-            && this->definition.info_header.bpp != 32
-        )
-    ) {
-        //Not supported:
-        this->file.close();
-        return EPD_BITMAP_STATUS::NOT_IMPLEMENTED; 
+    bmp_scaler_t scaler;
+    bmp_read_definition_t bmp_read;
+    EPD_BITMAP_STATUS status = this->beginScaledDraw(scaler, bmp_read, out_width, out_height, scale, reloadDefinition);
+    if (status != EPD_BITMAP_STATUS::VALID) {
+        return status;
+    }
+
+    //Only the visible part is dithered - same as a clipped drawBitmapDithered:
+    uint32_t    width   = scaler.out_width;
+    if (width + epd_x > (uint32_t)epd->width()) 
+        width = epd->width() - epd_x;
+    colorBits_t *line   = new colorBits_t[scaler.out_width];
+    if (line == nullptr) {
+        this->endScaledDraw(scaler);
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    }
+    bmp_diffusion_t diffusion;
+    if (!this->beginDiffusion(diffusion, filter, epd, (uint16_t)width)) {
+        delete[] line;
+        this->endScaledDraw(scaler);
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
     }
 
-    bmp_read_definition_t bmp_read = this->prepareBitmapReadDefinition(bmpStartRow, bmpStartCol, loadWidth, loadHeight);
+    //Output rows are dithered in the reader order - same as drawBitmapDithered:
+    bmp_row_reader_t reader;
+    this->beginRowReader(reader, bmp_read);
+    int32_t out_row;
+    int32_t visible_rows = epd->height() - epd_y;
+    while ((out_row = this->scaleNextRow(reader, bmp_read, scaler, line)) >= 0) {
+        //Rows below the screen are read (and skipped) - they don't take part in the diffusion:
+        if (out_row >= visible_rows) 
+            continue;
+        this->diffuseRow(diffusion, filter, epd, (int16_t)epd_x, (int16_t)(epd_y + out_row), nullptr, line);
+    }
+    this->endDiffusion(diffusion, epd);
+    this->endRowReader(reader);
+
+    delete[] line;
+    this->endScaledDraw(scaler);
+    return EPD_BITMAP_STATUS::DONE;
+}
+
+/**
+ * @brief prepares the diffusion taps of the filter kernel and allocates the error rows ring.
+ * The ring is kept in the EPD SRAM when it is used and has room - unless FORCE_RAM_BUFFER is set.
+ * 
+ * @param diffusion bmp_diffusion_t & the diffusion state to prepare.
+ * @param filter    BITMAP_DITHER_FILTER * the dither filter - its kernel is used.
+ * @param epd       SIKTEC_EPD * the epd to draw on.
+ * @param width     uint16_t the dithered columns - the strip width in strips mode.
+ * @param height    uint16_t the dithered rows in strips mode (the carried edge error) - 0 for none.
+ * @return bool false if the ring could not be allocated.
+ */
+bool SIKTEC_EPD_BITMAP::beginDiffusion(bmp_diffusion_t &diffusion, BITMAP_DITHER_FILTER *filter, SIKTEC_EPD *epd, const uint16_t width, const uint16_t height) {
     
-    //Allocate Buffer:
-    uint16_t sram_buffer;
-    int16_t *ram_buffer = nullptr;
-    bool in_sram = BITMAP_DITHER_FILTER::FORCE_RAM_BUFFER ? false : epd->is_using_sram();
-    if (in_sram) {
-        in_sram = epd->is_using_sram();
-        sram_buffer = epd->allocateSramArrayBuffer(
-            (uint16_t)(loadWidth * 2), 
-            sizeof(int16_t)
-        );
+    bitmap_dither_kernel_t kernel = filter->getKernel();
+    uint16_t divisor    = kernel.divisor ? kernel.divisor : 1;
+    diffusion.rows      = kernel.rows < 1 ? 1 : (kernel.rows > DITHER_KERNEL_MAX_ROWS ? DITHER_KERNEL_MAX_ROWS : kernel.rows);
+    diffusion.channels  = filter->error_channels > 1 ? DITHER_MAX_CHANNELS : 1;
+    diffusion.stride    = (width + DITHER_KERNEL_MAX_REACH * 2) * diffusion.channels;
+    diffusion.serpentine = filter->getSerpentine();
+    diffusion.tap_count = 0;
+    diffusion.reach     = 0;
+
+    //Taps - the current row only diffuses to the right of the pixel:
+    for (uint8_t r = 0; r < diffusion.rows; ++r) {
+        for (uint8_t c = r ? 0 : DITHER_KERNEL_MAX_REACH + 1; c < DITHER_KERNEL_COLUMNS; ++c) {
+            if (kernel.weights[r][c] == 0) 
+                continue;
+            bmp_dither_tap_t &tap = diffusion.taps[diffusion.tap_count++];
+            tap.row     = r;
+            tap.dx      = (int8_t)c - DITHER_KERNEL_MAX_REACH;
+            tap.weight  = (int16_t)((((uint32_t)kernel.weights[r][c] << DITHER_KERNEL_SHIFT) + divisor / 2) / divisor);
+            if (abs(tap.dx) > diffusion.reach) 
+                diffusion.reach = abs(tap.dx);
+        }
+    }
+
+    //Allocate the ring and the carried edge error (reach columns per row) after it:
+    uint16_t size = diffusion.rows * diffusion.stride;
+    diffusion.carry = height ? size : 0;
+    size += height * diffusion.reach * diffusion.channels;
+    diffusion.in_sram = BITMAP_DITHER_FILTER::FORCE_RAM_BUFFER ? false : epd->is_using_sram();
+    if (diffusion.in_sram) {
+        diffusion.sram_buffer = epd->allocateSramArrayBuffer(size, sizeof(int16_t));
+        //Not enough room left in the SRAM - falls back to RAM:
+        diffusion.in_sram = diffusion.sram_buffer != 0;
+    }
+    //Compact RAM ring - int8 errors when the filter values (and their error) fit:
+    int16_t bound = filter->valueBound();
+    diffusion.compact = !diffusion.in_sram && filter->getCompactErrors() && bound > 0 && bound <= DITHER_COMPACT_MAX;
+    if (diffusion.compact) {
+        diffusion.ram_compact = new int8_t[size];
+        if (diffusion.ram_compact == nullptr) 
+            return false;
+    } else if (!diffusion.in_sram) {
+        diffusion.ram_buffer = new int16_t[size];
+        if (diffusion.ram_buffer == nullptr) 
+            return false;
+    }
+    this->resetDiffusion(diffusion, epd, width, false, false);
+    return true;
+}
+
+/**
+ * @brief clears the error rows ring for a new pass - a new strip in strips mode.
+ * 
+ * @param diffusion bmp_diffusion_t & the diffusion state.
+ * @param epd       SIKTEC_EPD * the epd the ring was allocated on.
+ * @param width     uint16_t the dithered columns - up to the allocated width.
+ * @param carry_in  bool add the edge error carried from the strip on the left.
+ * @param carry_out bool save the edge error for the strip on the right.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::resetDiffusion(bmp_diffusion_t &diffusion, SIKTEC_EPD *epd, const uint16_t width, const bool carry_in, const bool carry_out) {
+    uint16_t size       = diffusion.rows * diffusion.stride;
+    diffusion.width     = width;
+    diffusion.first     = 0;
+    diffusion.row       = 0;
+    diffusion.carry_in  = carry_in && diffusion.carry;
+    diffusion.carry_out = carry_out && diffusion.carry;
+    if (diffusion.in_sram) {
+        int16_t zeros[BITMAP_DITHER_SEGMENT] = { 0 };
+        for (uint16_t i = 0; i < size; i += BITMAP_DITHER_SEGMENT) {
+            this->transferDiffusion(
+                diffusion, epd, i, zeros, 
+                size - i < BITMAP_DITHER_SEGMENT ? size - i : BITMAP_DITHER_SEGMENT, true
+            );
+        }
+    } else if (diffusion.compact) {
+        memset(diffusion.ram_compact, 0, size * sizeof(int8_t));
     } else {
-        in_sram = false;
-        ram_buffer = new int16_t[loadWidth * 2];
-    }
-
-    //fill buffer:
-    int16_t     bmpColorPixel;
-    uint8_t     color_buf[2];
-    for (uint16_t row = 0; row < 2; ++row) {
-        for (uint16_t col = 0; col < loadWidth; ++col) {
-            bmpColorPixel = (int16_t)this->getBitmapPixel(bmp_read, col, loadHeight - row - 1, filter);
-            if (in_sram) {
-                color_buf[0] = bmpColorPixel >> 8;
-                color_buf[1] = bmpColorPixel & 0xFF;
-                epd->setSramArrayBufferElement(sram_buffer, col + row * loadWidth, color_buf, 1);
-            } else {
-                ram_buffer[col + row * loadWidth] = bmpColorPixel;
-            }
+        memset(diffusion.ram_buffer, 0, size * sizeof(int16_t));
+    }
+}
+
+/**
+ * @brief reads / writes consecutive error values of the ring (or the carried edge error).
+ * 
+ * @param diffusion bmp_diffusion_t & the diffusion state.
+ * @param epd       SIKTEC_EPD * the epd the ring was allocated on.
+ * @param index     uint16_t the first element.
+ * @param values    int16_t * the values buffer.
+ * @param count     uint16_t number of elements.
+ * @param store     bool true to write the values - false to read them.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::transferDiffusion(bmp_diffusion_t &diffusion, SIKTEC_EPD *epd, const uint16_t index, int16_t *values, const uint16_t count, const bool store) {
+    if (diffusion.in_sram && store) {
+        epd->setSramArrayBufferElement(diffusion.sram_buffer, index, (uint8_t *)values, count);
+    } else if (diffusion.in_sram) {
+        epd->getSramArrayBufferElement(diffusion.sram_buffer, index, (uint8_t *)values, count);
+    } else if (diffusion.compact && store) {
+        //Saturated - the bound was checked when the ring was allocated (the rounding may pass it by a few):
+        for (uint16_t i = 0; i < count; ++i) {
+            diffusion.ram_compact[index + i] = values[i] > DITHER_COMPACT_MAX ? DITHER_COMPACT_MAX : (values[i] < -DITHER_COMPACT_MAX ? -DITHER_COMPACT_MAX : values[i]);
         }
+    } else if (diffusion.compact) {
+        for (uint16_t i = 0; i < count; ++i) {
+            values[i] = diffusion.ram_compact[index + i];
+        }
+    } else if (store) {
+        memcpy(diffusion.ram_buffer + index, values, count * sizeof(int16_t));
+    } else {
+        memcpy(values, diffusion.ram_buffer + index, count * sizeof(int16_t));
     }
-    #if SIKTEC_EPD_DEBUG_BITMAP_DITHER
-        Serial.println("Initial Dither Buffer:");
-        this->printDitherBuffer(sram_buffer, ram_buffer, epd, loadWidth);
-    #endif
+}
 
-    //Dither and shift:
-    uint32_t finalColumn = loadWidth - 1;
-    uint32_t finalRow    = loadHeight - 1; 
-    int16_t  dither_kernel[5];
-    int16_t  epd_col      = (int16_t)epd_x;
-    int16_t  epd_row      = (int16_t)epd_y;
-    for (uint16_t row = 0; row < loadHeight; ++row) {
-        for (uint16_t col = 0; col < loadWidth; ++col) {
-            //Current pixel:
-            if (in_sram) {
-                epd->getSramArrayBufferElement(sram_buffer, col, color_buf, 1);
-                dither_kernel[0] = (int16_t)((color_buf[0] << 8) | color_buf[1]);
-            } else {
-                dither_kernel[0] = ram_buffer[col];
+/**
+ * @brief dithers and draws a single row - each error row is updated in one pass per row.
+ * Columns are handled in segments of BITMAP_DITHER_SEGMENT - in SRAM mode every error row 
+ * of a segment is read and written back once (a window) instead of per neighbour element - 
+ * the compact (int8) RAM ring is windowed the same way.
+ * Serpentine odd rows are pulled first (added to the current error row) and dithered from 
+ * right to left with mirrored taps. Color filters diffuse every channel with the same taps.
+ * In strips mode the error that leaves the strip on the right is carried to the next strip 
+ * and the error that leaves it on the left is folded into its first column.
+ * NOTE: relies on an arithmetic right shift of negative values (gcc on every supported board).
+ * 
+ * @param diffusion bmp_diffusion_t & the diffusion state.
+ * @param filter    BITMAP_DITHER_FILTER * the dither filter.
+ * @param epd       SIKTEC_EPD * the epd to draw on.
+ * @param epd_x     int16_t the row first column on the EPD.
+ * @param epd_y     int16_t the row on the EPD.
+ * @param reader    bmp_row_reader_t * the row reader positioned on the row - nullptr to use line.
+ * @param line      colorBits_t * the raw row colors - used when reader is nullptr.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::diffuseRow(
+    bmp_diffusion_t &diffusion, BITMAP_DITHER_FILTER *filter, SIKTEC_EPD *epd, 
+    const int16_t epd_x, const int16_t epd_y, 
+    bmp_row_reader_t *reader, const colorBits_t *line
+) {
+
+    const int32_t  half      = 1 << (DITHER_KERNEL_SHIFT - 1);
+    const bool     reverse   = diffusion.serpentine && (diffusion.row & 1);
+    const int8_t   direction = reverse ? -1 : 1;
+    const bool     windowed  = diffusion.in_sram || diffusion.compact;
+    const uint8_t  ch        = diffusion.channels;
+    const uint16_t pad       = DITHER_KERNEL_MAX_REACH * ch; // padding elements on each side
+    const uint16_t columns   = BITMAP_DITHER_SEGMENT / ch;   // columns per segment
+    const uint16_t segments  = (diffusion.width + columns - 1) / columns;
+    int16_t  window[DITHER_KERNEL_MAX_ROWS][BITMAP_DITHER_SEGMENT + DITHER_KERNEL_MAX_REACH * 2 * DITHER_MAX_CHANNELS];
+    int16_t  *errors[DITHER_KERNEL_MAX_ROWS]; // errors[row][i * ch + c] is the error of column x + i channel c
+    uint16_t ring[DITHER_KERNEL_MAX_ROWS];    // row offsets in the ring
+    for (uint8_t r = 0; r < diffusion.rows; ++r) {
+        ring[r] = ((diffusion.first + r) % diffusion.rows) * diffusion.stride;
+    }
+
+    //The edge error carried from the strip on the left - spills to the right padding of narrow strips:
+    if (diffusion.carry_in) {
+        int16_t carried[DITHER_KERNEL_MAX_REACH * DITHER_MAX_CHANNELS];
+        int16_t current[DITHER_KERNEL_MAX_REACH * DITHER_MAX_CHANNELS];
+        uint16_t count = diffusion.reach * ch;
+        this->transferDiffusion(diffusion, epd, diffusion.carry + diffusion.row * count, carried, count, false);
+        this->transferDiffusion(diffusion, epd, ring[0] + pad, current, count, false);
+        for (uint8_t i = 0; i < count; ++i) {
+            current[i] += carried[i];
+        }
+        this->transferDiffusion(diffusion, epd, ring[0] + pad, current, count, true);
+    }
+
+    for (uint16_t n = 0; n < segments; ++n) {
+        uint16_t s      = reverse ? segments - 1 - n : n;
+        uint16_t x      = s * columns;
+        uint16_t count  = diffusion.width - x < columns ? diffusion.width - x : columns;
+        //Serpentine - the whole row is pulled (in reading order) before it's dithered backwards:
+        if (reverse && n == 0) {
+            for (uint16_t p = 0; p < segments; ++p) {
+                uint16_t px     = p * columns;
+                uint16_t pcount = diffusion.width - px < columns ? diffusion.width - px : columns;
+                int16_t *current = windowed ? window[0] : diffusion.ram_buffer + ring[0] + pad + px * ch;
+                if (windowed) 
+                    this->transferDiffusion(diffusion, epd, ring[0] + pad + px * ch, current, pcount * ch, false);
+                this->pullDitherPixels(filter, ch, reader, line, px, pcount, current);
+                if (windowed) 
+                    this->transferDiffusion(diffusion, epd, ring[0] + pad + px * ch, current, pcount * ch, true);
             }
-            //Right:
-            if (col < finalColumn) {
-                if (in_sram) {
-                    epd->getSramArrayBufferElement(sram_buffer, col + 1, color_buf, 1);
-                    dither_kernel[1] = (int16_t)((color_buf[0] << 8) | color_buf[1]);
-                } else {
-                    dither_kernel[1] = ram_buffer[col + 1];
-                }
+        }
+        //Error rows of the segment - the padding columns included:
+        for (uint8_t r = 0; r < diffusion.rows; ++r) {
+            if (windowed) {
+                this->transferDiffusion(diffusion, epd, ring[r] + x * ch, window[r], (count + DITHER_KERNEL_MAX_REACH * 2) * ch, false);
+                errors[r] = window[r] + pad;
             } else {
-                dither_kernel[1] = 0;
+                errors[r] = diffusion.ram_buffer + ring[r] + pad + x * ch;
             }
-            //Down Left:
-            if (col > 0 && row < finalRow) {
-                if (in_sram) {
-                    epd->getSramArrayBufferElement(sram_buffer, col + loadWidth - 1, color_buf, 1);
-                    dither_kernel[2] = (int16_t)((color_buf[0] << 8) | color_buf[1]);
-                } else {
-                    dither_kernel[2] = ram_buffer[col + loadWidth - 1];
+        }
+        //Source pixels - pulled sequentially and added to the current row error:
+        if (!reverse) {
+            this->pullDitherPixels(filter, ch, reader, line, x, count, errors[0]);
+        }
+        //Quantize, draw and distribute the error:
+        if (ch == 1) {
+            for (uint16_t k = 0; k < count; ++k) {
+                uint16_t i     = reverse ? count - 1 - k : k;
+                int16_t  color;
+                int16_t  value = errors[0][i];
+                int16_t  err   = value - filter->quantize(value, color);
+                epd->drawPixel(epd_x + x + i, epd_y, color);
+                for (uint8_t t = 0; t < diffusion.tap_count; ++t) {
+                    const bmp_dither_tap_t &tap = diffusion.taps[t];
+                    errors[tap.row][i + tap.dx * direction] += ((int32_t)err * tap.weight + half) >> DITHER_KERNEL_SHIFT;
                 }
-            } else {
-                dither_kernel[2] = 0;
+                //Consumed - the current row is reused as the last ring row:
+                errors[0][i] = 0;
             }
-            //Down:
-            if (row < finalRow) {
-                if (in_sram) {
-                    epd->getSramArrayBufferElement(sram_buffer, col + loadWidth, color_buf, 1);
-                    dither_kernel[3] = (int16_t)((color_buf[0] << 8) | color_buf[1]);
-                } else {
-                    dither_kernel[3] = ram_buffer[col + loadWidth];
+        } else {
+            for (uint16_t k = 0; k < count; ++k) {
+                uint16_t i     = reverse ? count - 1 - k : k;
+                int16_t  color;
+                int16_t  *value = errors[0] + i * ch;
+                int16_t  err[DITHER_MAX_CHANNELS];
+                for (uint8_t c = 0; c < ch; ++c) {
+                    err[c]   = value[c];
+                    value[c] = 0; // Consumed
                 }
-            } else {
-                dither_kernel[3] = 0;
-            }
-            //Down Right:
-            if (row < finalRow && col < finalColumn) {
-                if (in_sram) {
-                    epd->getSramArrayBufferElement(sram_buffer, col + loadWidth + 1, color_buf, 1);
-                    dither_kernel[4] = (int16_t)((color_buf[0] << 8) | color_buf[1]);
-                } else {
-                    dither_kernel[4] = ram_buffer[col + loadWidth + 1];
+                filter->quantizeChannels(err, color);
+                epd->drawPixel(epd_x + x + i, epd_y, color);
+                for (uint8_t t = 0; t < diffusion.tap_count; ++t) {
+                    const bmp_dither_tap_t &tap = diffusion.taps[t];
+                    int16_t *target = errors[tap.row] + (i + tap.dx * direction) * ch;
+                    for (uint8_t c = 0; c < ch; ++c) {
+                        target[c] += ((int32_t)err[c] * tap.weight + half) >> DITHER_KERNEL_SHIFT;
+                    }
                 }
-            } else {
-                dither_kernel[4] = 0;
             }
+        }
+        if (windowed) {
+            for (uint8_t r = 0; r < diffusion.rows; ++r) {
+                this->transferDiffusion(diffusion, epd, ring[r] + x * ch, window[r], (count + DITHER_KERNEL_MAX_REACH * 2) * ch, true);
+            }
+        }
+    }
+
+    //Strips - the padding columns hold the error that left the strip:
+    if (diffusion.carry) {
+        int16_t edge[(DITHER_KERNEL_MAX_REACH + 1) * DITHER_MAX_CHANNELS];
+        int16_t zeros[DITHER_KERNEL_MAX_REACH * DITHER_MAX_CHANNELS] = { 0 };
+        int16_t behind[DITHER_MAX_CHANNELS] = { 0 }; // right to left rows - the current row error that left the strip
+        if (diffusion.carry_in && diffusion.rows > 1) {
+            this->transferDiffusion(diffusion, epd, ring[0], edge, pad, false);
+            for (uint8_t i = 0; i < pad; ++i) {
+                behind[i % ch] += edge[i];
+            }
+        }
+        //Right - carried to the next strip (complete once the row is done):
+        uint16_t right = ring[0] + pad + diffusion.width * ch;
+        if (diffusion.carry_out) {
+            this->transferDiffusion(diffusion, epd, right, edge, diffusion.reach * ch, false);
+            this->transferDiffusion(diffusion, epd, diffusion.carry + diffusion.row * diffusion.reach * ch, edge, diffusion.reach * ch, true);
+        }
+        this->transferDiffusion(diffusion, epd, right, zeros, pad, true);
+        this->transferDiffusion(diffusion, epd, ring[0], zeros, pad, true);
+        //Left - folded into the first column of the next rows (the strip on the left is done):
+        for (uint8_t r = 1; diffusion.carry_in && r < diffusion.rows; ++r) {
+            this->transferDiffusion(diffusion, epd, ring[r], edge, pad + ch, false);
+            for (uint8_t i = 0; i < pad; ++i) {
+                edge[pad + i % ch] += edge[i];
+                edge[i] = 0;
+            }
+            for (uint8_t c = 0; r == 1 && c < ch; ++c) {
+                edge[pad + c] += behind[c];
+            }
+            this->transferDiffusion(diffusion, epd, ring[r], edge, pad + ch, true);
+        }
+    }
+    diffusion.first = (diffusion.first + 1) % diffusion.rows;
+    diffusion.row++;
+}
+
+/**
+ * @brief pulls the next source pixels of the row and adds them to the current error row.
+ * 
+ * @param filter    BITMAP_DITHER_FILTER * the dither filter.
+ * @param channels  uint8_t the error channels per pixel.
+ * @param reader    bmp_row_reader_t * the row reader positioned on the row - nullptr to use line.
+ * @param line      colorBits_t * the raw row colors - used when reader is nullptr.
+ * @param x         uint16_t the first column (line index).
+ * @param count     uint16_t number of pixels.
+ * @param current   int16_t * the current error row elements of column x.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::pullDitherPixels(
+    BITMAP_DITHER_FILTER *filter, const uint8_t channels, 
+    bmp_row_reader_t *reader, const colorBits_t *line, 
+    const uint16_t x, const uint16_t count, int16_t *current
+) {
+    int16_t values[DITHER_MAX_CHANNELS];
+    for (uint16_t i = 0; i < count; ++i) {
+        colorBits_t pixel = reader != nullptr 
+            ? this->readRowPixel(*reader, filter) 
+            : this->pixelColorProccess(line[x + i], filter);
+        if (channels == 1) {
+            current[i] += (int16_t)pixel;
+            continue;
+        }
+        filter->channels(pixel, values);
+        for (uint8_t c = 0; c < channels; ++c) {
+            current[i * channels + c] += values[c];
+        }
+    }
+}
+
+/**
+ * @brief releases the error rows ring.
+ * 
+ * @param diffusion bmp_diffusion_t & the diffusion state.
+ * @param epd       SIKTEC_EPD * the epd the ring was allocated on.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::endDiffusion(bmp_diffusion_t &diffusion, SIKTEC_EPD *epd) {
+    if (diffusion.in_sram) {
+        epd->releaseSramArrayBuffer();
+    } else if (diffusion.compact) {
+        delete[] diffusion.ram_compact;
+        diffusion.ram_compact = nullptr;
+    } else {
+        delete[] diffusion.ram_buffer;
+        diffusion.ram_buffer = nullptr;
+    }
+}
+
+/**
+ * @brief draws the bitmap with a predefined filter (dithering included) and saves 
+ * the drawn region as a pre-packed .epd image - see SIKTEC_EPD_IMAGE.
+ * The epd framebuffer is used as the drawing surface.
+ * 
+ * @param builtin_filters   - the builtin filter to apply - BITMAP_FILTER enum.
+ * @param epd_x             - uint32_t the top-left X position on the EPD.
+ * @param epd_y             - uint32_t the top-left Y position on the EPD.
+ * @param epd               - SIKTEC_EPD * the pointer to the epd to draw on.
+ * @param out               - FatFile & an open writable file.
+ * @param bmp_sc            - bitmap start column (from left)
+ * @param bmp_sr            - bitmap start row (from top)
+ * @param bmp_cw            - bitmap clip width 0 means fullwidth
+ * @param bmp_ch            - bitmap clip height 0 means fullheight
+ * @return EPD_BITMAP_STATUS DONE when saved.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::exportImage(
+    BITMAP_FILTER   builtin_filters,
+    uint32_t        epd_x,
+    uint32_t        epd_y,
+    SIKTEC_EPD      *epd,
+    FatFile         &out,
+    uint32_t        bmp_sc,
+    uint32_t        bmp_sr,
+    uint32_t        bmp_cw,
+    uint32_t        bmp_ch
+) {
+    EPD_BITMAP_STATUS drawn = this->drawBitmap(builtin_filters, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch);
+    return this->saveDrawnImage(drawn, epd_x, epd_y, epd, out, bmp_sc, bmp_sr, bmp_cw, bmp_ch);
+}
+
+/**
+ * @brief draws the bitmap with a custom filter and saves the drawn region as a 
+ * pre-packed .epd image - see SIKTEC_EPD_IMAGE.
+ * The epd framebuffer is used as the drawing surface.
+ * 
+ * @param filter            - BITMAP_FILTER_IMPLEMENTATION * the filter object pointer.
+ * @param epd_x             - uint32_t the top-left X position on the EPD.
+ * @param epd_y             - uint32_t the top-left Y position on the EPD.
+ * @param epd               - SIKTEC_EPD * the pointer to the epd to draw on.
+ * @param out               - FatFile & an open writable file.
+ * @param bmp_sc            - bitmap start column (from left)
+ * @param bmp_sr            - bitmap start row (from top)
+ * @param bmp_cw            - bitmap clip width 0 means fullwidth
+ * @param bmp_ch            - bitmap clip height 0 means fullheight
+ * @return EPD_BITMAP_STATUS DONE when saved.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::exportImage(
+    BITMAP_FILTER_IMPLEMENTATION *filter,
+    uint32_t        epd_x,
+    uint32_t        epd_y,
+    SIKTEC_EPD      *epd,
+    FatFile         &out,
+    uint32_t        bmp_sc,
+    uint32_t        bmp_sr,
+    uint32_t        bmp_cw,
+    uint32_t        bmp_ch
+) {
+    EPD_BITMAP_STATUS drawn = this->drawBitmap(filter, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch);
+    return this->saveDrawnImage(drawn, epd_x, epd_y, epd, out, bmp_sc, bmp_sr, bmp_cw, bmp_ch);
+}
 
-            //Dither the pixels - distributes the error:
-            filter->dither(dither_kernel);
-            
-            //save it back to buffer:
-            if (in_sram) {
-                color_buf[0] = dither_kernel[0] >> 8;
-                color_buf[1] = dither_kernel[0] & 0xFF;
-                epd->setSramArrayBufferElement(sram_buffer, col, color_buf, 1);
-                if (col < finalColumn) {
-                    color_buf[0] = dither_kernel[1] >> 8;
-                    color_buf[1] = dither_kernel[1] & 0xFF;
-                    epd->setSramArrayBufferElement(sram_buffer, col + 1, color_buf, 1);
-                }
-                if (col > 0 && row < finalRow) {
-                    color_buf[0] = dither_kernel[2] >> 8;
-                    color_buf[1] = dither_kernel[2] & 0xFF;
-                    epd->setSramArrayBufferElement(sram_buffer, col + loadWidth - 1, color_buf, 1);
-                }
-                if (row < finalRow) {
-                    color_buf[0] = dither_kernel[3] >> 8;
-                    color_buf[1] = dither_kernel[3] & 0xFF;
-                    epd->setSramArrayBufferElement(sram_buffer, col + loadWidth, color_buf, 1);
-                }
-                if (row < finalRow && col < finalColumn) {
-                    color_buf[0] = dither_kernel[4] >> 8;
-                    color_buf[1] = dither_kernel[4] & 0xFF;
-                    epd->setSramArrayBufferElement(sram_buffer, col + loadWidth + 1, color_buf, 1);
-                }
-                // #if SIKTEC_EPD_DEBUG_BITMAP_DITHER
-                //     PRINT_DEBUG_BUFFER("Dither Buffer Pixel: %d %d \n", col, row);
-                //     this->printDitherBuffer(sram_buffer, ram_buffer, epd, loadWidth);
-                // #endif
-            } else {
-                ram_buffer[col] = dither_kernel[0];
-                if (col < finalColumn) {
-                    ram_buffer[col + 1] = dither_kernel[1];
-                }
-                if (col > 0 && row < finalRow) {
-                    ram_buffer[col + loadWidth - 1] = dither_kernel[2];
-                }
-                if (row < finalRow) {
-                    ram_buffer[col + loadWidth] = dither_kernel[3];
-                }
-                if (row < finalRow && col < finalColumn) {
-                    ram_buffer[col + loadWidth + 1] = dither_kernel[4];
-                }
-            }
-        }
-        #if SIKTEC_EPD_DEBUG_BITMAP_DITHER
-            PRINT_DEBUG_BUFFER("After Dither Buffer Row: %d \n", row);
-            this->printDitherBuffer(sram_buffer, ram_buffer, epd, loadWidth);
-        #endif
-        //draw raw and shift:
-        for (uint16_t col = 0; col < loadWidth; ++col) {
-            if (in_sram) {
-                //Draw:
-                epd->getSramArrayBufferElement(sram_buffer, col, color_buf, 1);
-                epd->drawPixel(epd_col++, epd_row, (color_buf[0] << 8) | color_buf[1]);
-                //Shift:
-                epd->getSramArrayBufferElement(sram_buffer, col + loadWidth, color_buf, 1);
-                epd->setSramArrayBufferElement(sram_buffer, col, color_buf, 1);
-                //Add New Row to buffer:
-                if (loadHeight - row > 1) {
-                    bmpColorPixel = (int16_t)this->getBitmapPixel(bmp_read, col, loadHeight - row - 2, filter);
-                    color_buf[0] = bmpColorPixel >> 8;
-                    color_buf[1] = bmpColorPixel & 0xFF;
-                    epd->setSramArrayBufferElement(sram_buffer, col + loadWidth, color_buf, 1);
-                }
-            } else {
-                //Draw:
-                epd->drawPixel(epd_col++, epd_row, ram_buffer[col]);
-                //Shift:
-                ram_buffer[col] = ram_buffer[col + loadWidth];
-                //Add New Row to buffer:
-                if (loadHeight - row > 1) {
-                    ram_buffer[col + loadWidth] = (int16_t)this->getBitmapPixel(bmp_read, col, loadHeight - row - 2, filter);
-                }
-            }
-        }
-        #if SIKTEC_EPD_DEBUG_BITMAP_DITHER
-            PRINT_DEBUG_BUFFER("After Dither Buffer Shift: %d \n", row);
-            this->printDitherBuffer(sram_buffer, ram_buffer, epd, loadWidth);
-        #endif
-        epd_row++; 
-        epd_col = (int16_t)epd_x;
-    }
+/**
+ * @brief draws the bitmap with a dither filter (drawBitmapDithered - the filter kernel, 
+ * serpentine, strips and compact settings apply) and saves the drawn region as a 
+ * pre-packed .epd image - see SIKTEC_EPD_IMAGE.
+ * The epd framebuffer is used as the drawing surface.
+ * 
+ * @param filter            - BITMAP_DITHER_FILTER * the dither filter object pointer.
+ * @param epd_x             - uint32_t the top-left X position on the EPD.
+ * @param epd_y             - uint32_t the top-left Y position on the EPD.
+ * @param epd               - SIKTEC_EPD * the pointer to the epd to draw on.
+ * @param out               - FatFile & an open writable file.
+ * @param bmp_sc            - bitmap start column (from left)
+ * @param bmp_sr            - bitmap start row (from top)
+ * @param bmp_cw            - bitmap clip width 0 means fullwidth
+ * @param bmp_ch            - bitmap clip height 0 means fullheight
+ * @return EPD_BITMAP_STATUS DONE when saved.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::exportImage(
+    BITMAP_DITHER_FILTER *filter,
+    uint32_t        epd_x,
+    uint32_t        epd_y,
+    SIKTEC_EPD      *epd,
+    FatFile         &out,
+    uint32_t        bmp_sc,
+    uint32_t        bmp_sr,
+    uint32_t        bmp_cw,
+    uint32_t        bmp_ch
+) {
+    EPD_BITMAP_STATUS drawn = this->drawBitmapDithered(filter, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch);
+    return this->saveDrawnImage(drawn, epd_x, epd_y, epd, out, bmp_sc, bmp_sr, bmp_cw, bmp_ch);
+}
 
-    //Release:
-    if (in_sram) {
-        epd->releaseSramArrayBuffer();
-    } else {
-        delete ram_buffer;
+/**
+ * @brief saves the region covered by a successful draw call as an .epd image.
+ * 
+ * @param drawn             - the draw call result.
+ * @return EPD_BITMAP_STATUS DONE when saved.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::saveDrawnImage(
+    EPD_BITMAP_STATUS drawn, uint32_t epd_x, uint32_t epd_y, SIKTEC_EPD *epd, FatFile &out,
+    uint32_t bmp_sc, uint32_t bmp_sr, uint32_t bmp_cw, uint32_t bmp_ch
+) {
+    if (drawn != EPD_BITMAP_STATUS::DONE) {
+        return drawn;
+    }
+    //Same clip as the draw - the screen bounds are clipped by the image:
+    uint32_t bmpWidth = (bmp_cw && bmp_cw < (uint32_t)this->width()) ? bmp_cw : this->width();
+    if (bmpWidth + bmp_sc > (uint32_t)this->width()) {
+        bmpWidth -= bmpWidth + bmp_sc - this->width();
+    }
+    uint32_t bmpHeight  = bmp_ch && bmp_ch < (uint32_t)this->height() ? bmp_ch : this->height();
+    if (bmpHeight + bmp_sr > (uint32_t)this->height()) {
+        bmpHeight -= bmpHeight + bmp_sr - this->height();
+    }
+    switch (SIKTEC_EPD_IMAGE::save(epd, out, epd_x, epd_y, bmpWidth, bmpHeight)) {
+        case EPD_IMAGE_STATUS::IMAGE_DONE:
+        case EPD_IMAGE_STATUS::IMAGE_OUT_OF_BOUNDS: // nothing drawn - nothing to save
+            return EPD_BITMAP_STATUS::DONE;
+        default:
+            return EPD_BITMAP_STATUS::ERROR_WRITE_FILE;
     }
-    
-    this->file.close();
-    return EPD_BITMAP_STATUS::DONE;
 }
 
 /**
  * @brief Return a bitmap definition parsed from the headers
  * will auto detect which bitmap it is and which format to use.
+ * NOTE: with createPalette the palette and the 16 / 32 bpp decode tables are allocated - 
+ * the caller owns them and releases them with freeBitmapDefinition. Without it nothing is 
+ * allocated (the definition can't be used for drawing 16 / 32 bpp bitmaps).
  * 
- * @param createPalette default False - Whether to create a color palette or not.
- * @return bmp_def_t
+ * @param createPalette default False - Whether to create a color palette and decode tables or not.
+ * @return bmp_def_t - status ERROR_MEMORY when the allocations failed (nothing is kept).
  */
 bmp_def_t SIKTEC_EPD_BITMAP::getBitmapDefinition(bool createPalette) {
     bool closeAfter = false;
@@ -767,6 +1789,13 @@ bmp_def_t SIKTEC_EPD_BITMAP::getBitmapDefinition(bool createPalette) {
                     //Set palette if needed:
                     if (createPalette && def.palette_size > 0) {
                         def.palette = new colorBits_t[def.palette_size];
+                        if (def.palette == nullptr) {
+                            def.status = EPD_BITMAP_STATUS::ERROR_MEMORY;
+                            if (closeAfter) {
+                                this->file.close();
+                            }
+                            return def;
+                        }
                         //Store the color as 32bit uinteger -
                         //BMP format is BGRA or BGR this will flip and store ARGB
                         //First make sure what is the used color size:
@@ -790,7 +1819,13 @@ bmp_def_t SIKTEC_EPD_BITMAP::getBitmapDefinition(bool createPalette) {
                         }
                     }
 
-                    def.status = EPD_BITMAP_STATUS::VALID;
+                    //Channel masks and decode tables of 16 / 32 bpp bitmaps:
+                    if ((def.info_header.bpp == 16 || def.info_header.bpp == 32) && !this->prepareBitfields(def, createPalette)) {
+                        SIKTEC_EPD_BITMAP::freeBitmapDefinition(def);
+                        def.status = EPD_BITMAP_STATUS::ERROR_MEMORY;
+                    } else {
+                        def.status = EPD_BITMAP_STATUS::VALID;
+                    }
 
                 } else {
                     def.status = EPD_BITMAP_STATUS::UNSUPPORTED_BMP_VARIANT;
@@ -810,6 +1845,107 @@ bmp_def_t SIKTEC_EPD_BITMAP::getBitmapDefinition(bool createPalette) {
     return def;
 }
 
+/**
+ * @brief parses the channel masks and builds the bitfields decode tables.
+ * Masks are taken from the file when BI_BITFIELDS is used, otherwise the defaults 
+ * of uncompressed bitmaps are used (16bpp -> RGB555, 32bpp -> XRGB8888).
+ * Each channel gets a shift + mask and a small table that scales the channel value 
+ * to the result color depth (565 or 888) - so decoding is only shifts and lookups.
+ * 
+ * @param def           - the definition to prepare - file should be open.
+ * @param createTables  - allocate the decode tables (owned by the definition) - masks only otherwise.
+ * @return bool - false when the tables could not be allocated.
+ */
+bool SIKTEC_EPD_BITMAP::prepareBitfields(bmp_def_t &def, const bool createTables) {
+    bmp_bitfields_t &bitfields = def.bitfields;
+    if ((  def.info_header.compression == BMP_COMPRESSION::BI_BITFIELDS 
+        || def.info_header.compression == BMP_COMPRESSION::BI_ALPHABITFIELDS)
+        && def.variant != BMP_VARIANT::OS22XBITMAPHEADER_64
+    ) {
+        //Masks are stored right after the 40 bytes info header - inside bigger headers or following it:
+        this->seekSet(BITMAP_FILEHEADER_SIZE + BMP_VARIANT::BITMAPINFOHEADER_40);
+        bitfields.masks[0] = this->read32();
+        bitfields.masks[1] = this->read32();
+        bitfields.masks[2] = this->read32();
+        if (def.variant != BMP_VARIANT::BITMAPINFOHEADER_40 || def.info_header.compression == BMP_COMPRESSION::BI_ALPHABITFIELDS) {
+            bitfields.masks[3] = this->read32();
+        }
+    }
+    if ((bitfields.masks[0] | bitfields.masks[1] | bitfields.masks[2]) == 0) {
+        if (def.info_header.bpp == 16) {
+            bitfields.masks[0] = 0x7C00;
+            bitfields.masks[1] = 0x03E0;
+            bitfields.masks[2] = 0x001F;
+        } else {
+            bitfields.masks[0] = 0x00FF0000;
+            bitfields.masks[1] = 0x0000FF00;
+            bitfields.masks[2] = 0x000000FF;
+        }
+    }
+
+    //Result channel depth:
+    const uint8_t depth[3] = {
+        (uint8_t)(bitmap_color_result == BITMAP_COLOR_MODE::COLOR565 ? 5 : 8),
+        (uint8_t)(bitmap_color_result == BITMAP_COLOR_MODE::COLOR565 ? 6 : 8),
+        (uint8_t)(bitmap_color_result == BITMAP_COLOR_MODE::COLOR565 ? 5 : 8)
+    };
+
+    //Shifts and masks - channels deeper then the result are truncated by the shift:
+    uint8_t  keep[3];
+    uint16_t tables_size = 0;
+    for (uint8_t c = 0; c < 3; ++c) {
+        uint32_t mask  = bitfields.masks[c];
+        uint8_t  shift = 0;
+        uint8_t  bits  = 0;
+        while (mask && !(mask & 0x1)) { mask >>= 1; ++shift; }
+        while (mask & 0x1) { mask >>= 1; ++bits; }
+        keep[c] = bits > depth[c] ? depth[c] : bits;
+        bitfields.shift[c] = shift + (bits - keep[c]);
+        bitfields.mask[c]  = (uint8_t)((1 << keep[c]) - 1);
+        tables_size += (uint16_t)1 << keep[c];
+    }
+
+    //Scale tables:
+    if (!createTables) {
+        return true;
+    }
+    bitfields.scale[0] = new uint8_t[tables_size];
+    if (bitfields.scale[0] == nullptr) {
+        return false;
+    }
+    bitfields.scale[1] = bitfields.scale[0] + ((uint16_t)1 << keep[0]);
+    bitfields.scale[2] = bitfields.scale[1] + ((uint16_t)1 << keep[1]);
+    for (uint8_t c = 0; c < 3; ++c) {
+        uint16_t max_in  = bitfields.mask[c];
+        uint16_t max_out = (1 << depth[c]) - 1;
+        for (uint16_t v = 0; v <= max_in; ++v) {
+            bitfields.scale[c][v] = max_in ? (uint8_t)((v * max_out + max_in / 2) / max_in) : 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief decodes a 16 / 32 bpp pixel with the bitfields tables and applies the filter.
+ * 
+ * @param pixel     - uint32_t the raw pixel as stored in the file.
+ * @param filter    - the filter to apply.
+ * @return colorBits_t - pixel color bitfield
+ */
+colorBits_t SIKTEC_EPD_BITMAP::bitfieldsColorProccess(const uint32_t pixel, BITMAP_FILTER_IMPLEMENTATION *filter) {
+    const bmp_bitfields_t &bitfields = this->definition.bitfields;
+    uint8_t R = bitfields.scale[0][(pixel >> bitfields.shift[0]) & bitfields.mask[0]];
+    uint8_t G = bitfields.scale[1][(pixel >> bitfields.shift[1]) & bitfields.mask[1]];
+    uint8_t B = bitfields.scale[2][(pixel >> bitfields.shift[2]) & bitfields.mask[2]];
+    if (filter != nullptr) {
+        return filter->kernel(R, G, B);
+    }
+    if (bitmap_color_result == BITMAP_COLOR_MODE::COLOR565) {
+        return (colorBits_t)(((uint16_t)R << 11) | ((uint16_t)G << 5) | B);
+    }
+    return (colorBits_t)(((uint32_t)R << 16) | ((uint32_t)G << 8) | B);
+}
+
 /**
  * @brief Return the bitmap type (Header Format) - Based on the header size.
  * 
@@ -842,6 +1978,7 @@ BMP_VARIANT SIKTEC_EPD_BITMAP::bitmapVariant() {
 
 /**
  * @brief returns struct with all needed values for reading a bitmap at a specific region
+ * start_row is the stored row index (bottom-up or top-down) of the first row of the region in the file.
  * 
  * @param bmp_sr        - uint32_t the bitmap starting point Y / Row (From Top).
  * @param bmp_sc        - uint32_t the bitmap starting point X / Col (From Left).
@@ -852,7 +1989,10 @@ BMP_VARIANT SIKTEC_EPD_BITMAP::bitmapVariant() {
 bmp_read_definition_t SIKTEC_EPD_BITMAP::prepareBitmapReadDefinition(const uint32_t bmp_sr, const uint32_t bmp_sc, const uint32_t loadWidth, const uint32_t loadHeight) {
 
     bmp_read_definition_t bmp_read;
-    bmp_read.start_row      = bmp_sr;       //user defined stating row
+    //Bottom-up bitmaps store the last row of the clip window first:
+    bmp_read.start_row      = this->definition.flip 
+                                ? this->height() - bmp_sr - loadHeight 
+                                : bmp_sr;   //stored index of the first stored row
     bmp_read.start_col      = bmp_sc;       //user defined stating column
     bmp_read.read_width     = loadWidth;    //user defined and adjusted width
     bmp_read.read_height    = loadHeight;   //user defined and adjusted height
@@ -897,58 +2037,574 @@ bmp_read_definition_t SIKTEC_EPD_BITMAP::prepareBitmapReadDefinition(const uint3
 }
 
 /**
- * @brief returns a single pixel color directly from the bitmap
+ * @brief true if the compression method is supported for the bitmap bpp.
+ * 
+ * @return bool
+ */
+bool SIKTEC_EPD_BITMAP::supportedCompression() {
+    switch (this->definition.info_header.compression) {
+        case BMP_COMPRESSION::BI_RGB:
+            return true;
+        case BMP_COMPRESSION::BI_RLE8:
+            return this->definition.info_header.bpp == 8;
+        case BMP_COMPRESSION::BI_RLE4:
+            return this->definition.info_header.bpp == 4;
+        case BMP_COMPRESSION::BI_BITFIELDS:
+        case BMP_COMPRESSION::BI_ALPHABITFIELDS:
+            return this->definition.info_header.bpp == 16 || this->definition.info_header.bpp == 32;
+    }
+    return false;
+}
+
+/**
+ * @brief prepares a row reader that walks the clipped rows.
+ * By default rows are delivered from top to bottom - When the pixel array is stored bottom-up
+ * the reader starts at the last row of the clip window and steps backwards.
+ * In file order rows are delivered as stored which means the file is read strictly forward.
+ * Top-down bitmaps are always read forward and RLE streams are always read in file order.
+ * 
+ * @param reader      - the reader state to initialize.
+ * @param bitmap_read - The read operation definition.
+ * @param file_order  - deliver the rows in the order they are stored in the file.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::beginRowReader(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read, const bool file_order) {
+    reader.rle              = this->definition.info_header.compression == BMP_COMPRESSION::BI_RLE8
+                            || this->definition.info_header.compression == BMP_COMPRESSION::BI_RLE4;
+    reader.rows_left        = bitmap_read.read_height;
+    reader.row_bytes_left   = 0;
+    reader.buffer_pos       = 0;
+    reader.buffer_len       = 0;
+    if (reader.rle) {
+        reader.row_direction = this->definition.flip ? -1 : 1;
+        reader.rle_op        = BMP_RLE_OP::RLE_NONE;
+        reader.rle_count     = 0;
+        reader.rle_skip      = 0;
+        reader.rle_line      = 0;
+        reader.rle_x         = 0;
+        //The whole stream is pulled sequentially:
+        this->seekSet(this->definition.file_header.array_start);
+        reader.row_bytes_left = this->file.fileSize() > this->definition.file_header.array_start 
+                                ? this->file.fileSize() - this->definition.file_header.array_start
+                                : 0;
+    } else if (file_order || !this->definition.flip) {
+        //Top-down bitmaps are in file order anyway:
+        reader.row_direction = this->definition.flip ? -1 : 1;
+        reader.row_address   = bitmap_read.start_row_address + bitmap_read.column_offset_bytes;
+        reader.row_step      = (int32_t)bitmap_read.row_bit_size;
+    } else {
+        reader.row_direction = 1;
+        reader.row_address   = bitmap_read.start_row_address 
+                             + (bitmap_read.read_height - 1) * bitmap_read.row_bit_size
+                             + bitmap_read.column_offset_bytes;
+        reader.row_step      = -(int32_t)bitmap_read.row_bit_size;
+    }
+}
+
+/**
+ * @brief runs the filter once per palette entry and attaches the result table to the reader.
+ * Palettized pixels are then translated with a single lookup instead of a kernel call per pixel.
+ * Skipped when the region has fewer pixels than the palette or memory can't be allocated.
+ * 
+ * @param reader      - the reader state.
+ * @param bitmap_read - The read operation definition.
+ * @param filter      - the filter to apply.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::prefilterPalette(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read, BITMAP_FILTER_IMPLEMENTATION *filter) {
+    uint16_t size = (uint16_t)this->definition.palette_size;
+    if (this->definition.palette == nullptr 
+        || size == 0 
+        || (uint32_t)bitmap_read.read_width * bitmap_read.read_height <= size
+        || (filter != nullptr && filter->position_dependent)
+    ) return;
+    reader.palette_lut = new colorBits_t[size];
+    if (reader.palette_lut == nullptr) 
+        return;
+    for (uint16_t i = 0; i < size; ++i) {
+        reader.palette_lut[i] = this->pixelColorProccess(this->definition.palette[i], filter);
+    }
+    reader.palette_lut_size = size;
+}
+
+/**
+ * @brief releases any memory attached to the row reader.
+ * 
+ * @param reader - the reader state.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::endRowReader(bmp_row_reader_t &reader) {
+    delete[] reader.palette_lut;
+    reader.palette_lut      = nullptr;
+    reader.palette_lut_size = 0;
+}
+
+/**
+ * @brief moves the row reader to the next row - a single seek per row.
+ * RLE streams are decoded forward to the next row start column instead.
+ * 
+ * @param reader      - the reader state.
+ * @param bitmap_read - The read operation definition.
+ * @return bool - false when there are no more rows to read.
+ */
+bool SIKTEC_EPD_BITMAP::nextBitmapRow(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read) {
+    if (reader.rows_left == 0) 
+        return false;
+    if (reader.rle) {
+        uint32_t line = bitmap_read.start_row + bitmap_read.read_height - reader.rows_left;
+        while (reader.rle_line < line) {
+            this->rleAdvanceLine(reader);
+        }
+        for (uint32_t c = 0; c < bitmap_read.start_col; ++c) {
+            this->readRleIndex(reader);
+        }
+        reader.rows_left--;
+        return true;
+    }
+    this->seekSet(reader.row_address);
+    //Only the clipped bytes of the row are pulled (1 / 4 bpp may start mid byte):
+    reader.row_bytes_left = ((bitmap_read.column_skip_bytes + bitmap_read.read_width) * this->definition.info_header.bpp + 7) / 8;
+    reader.buffer_pos     = 0;
+    reader.buffer_len     = 0;
+    reader.row_address   += reader.row_step;
+    reader.rows_left--;
+    //Packed rows - load the first byte and skip the leading pixels:
+    if (this->definition.info_header.bpp < 8) {
+        reader.pixel_byte = this->readRowByte(reader);
+        reader.pixel_pos  = (uint8_t)bitmap_read.column_skip_bytes;
+    }
+    return true;
+}
+
+/**
+ * @brief moves the row reader past the next row without reading it.
+ * RLE streams are decoded forward to the next row instead.
+ * 
+ * @param reader      - the reader state.
+ * @param bitmap_read - The read operation definition.
+ * @return bool - false when there are no more rows to skip.
+ */
+bool SIKTEC_EPD_BITMAP::skipBitmapRow(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read) {
+    if (reader.rle) {
+        return this->nextBitmapRow(reader, bitmap_read);
+    }
+    if (reader.rows_left == 0) 
+        return false;
+    reader.row_address += reader.row_step;
+    reader.rows_left--;
+    return true;
+}
+
+/**
+ * @brief pulls a single byte of the current row from the reader buffer.
+ * refills the buffer in chunks of SIKTEC_EPD_BITMAP_READ_BUFFER bytes.
+ * 
+ * @param reader - the reader state.
+ * @return uint8_t 
+ */
+uint8_t SIKTEC_EPD_BITMAP::readRowByte(bmp_row_reader_t &reader) {
+    if (reader.buffer_pos >= reader.buffer_len) {
+        uint16_t chunk = reader.row_bytes_left < SIKTEC_EPD_BITMAP_READ_BUFFER 
+                        ? (uint16_t)reader.row_bytes_left 
+                        : SIKTEC_EPD_BITMAP_READ_BUFFER;
+        if (chunk == 0) 
+            return 0;
+        reader.buffer_len      = (uint16_t)this->file.read(reader.buffer, chunk);
+        reader.buffer_pos      = 0;
+        reader.row_bytes_left -= chunk;
+        if (reader.buffer_len == 0 || reader.buffer_len > chunk) {
+            reader.buffer_len = 0;
+            return 0;
+        }
+    }
+    return reader.buffer[reader.buffer_pos++];
+}
+
+/**
+ * @brief pulls the next palette index of the current row (1, 4, 8 bpp).
+ * packed bytes are unpacked with the 1 / 4 bpp lookup tables.
+ * 
+ * @param reader - the reader state.
+ * @return uint8_t - the palette index.
+ */
+uint8_t SIKTEC_EPD_BITMAP::readRowIndex(bmp_row_reader_t &reader) {
+    if (reader.rle) {
+        return this->readRleIndex(reader);
+    }
+    switch (this->definition.info_header.bpp) {
+        case 1: {
+            if (reader.pixel_pos == 8) {
+                reader.pixel_byte = this->readRowByte(reader);
+                reader.pixel_pos  = 0;
+            }
+            return (reader.pixel_byte & BITMAP_1BPP_MASK[reader.pixel_pos++]) ? 1 : 0;
+        }
+        case 4: {
+            if (reader.pixel_pos == 2) {
+                reader.pixel_byte = this->readRowByte(reader);
+                reader.pixel_pos  = 0;
+            }
+            return (reader.pixel_byte >> BITMAP_4BPP_SHIFT[reader.pixel_pos++]) & 0x0F;
+        }
+    }
+    return this->readRowByte(reader);
+}
+
+/**
+ * @brief parses the next RLE escape / run from the stream.
+ * Skipped pixels (delta and end of line escapes) are expressed as runs of palette index 0.
+ * 
+ * @param reader - the reader state.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::rleParseOp(bmp_row_reader_t &reader) {
+    uint8_t b0 = this->readRowByte(reader);
+    uint8_t b1 = this->readRowByte(reader);
+    reader.rle_phase = 0;
+    if (b0) {
+        //Encoded run:
+        reader.rle_op    = BMP_RLE_OP::RLE_RUN;
+        reader.rle_count = b0;
+        reader.rle_value = b1;
+        return;
+    }
+    switch (b1) {
+        case 0: { // End of line:
+            reader.rle_op    = BMP_RLE_OP::RLE_SKIP;
+            reader.rle_skip  = 1;
+            reader.rle_count = 0;
+            reader.rle_value = 0;
+        } break;
+        case 1: { // End of bitmap:
+            reader.rle_op    = BMP_RLE_OP::RLE_END;
+            reader.rle_count = 0;
+        } break;
+        case 2: { // Delta - move right and up, landing column is reached with a zero run:
+            uint8_t dx = this->readRowByte(reader);
+            uint8_t dy = this->readRowByte(reader);
+            reader.rle_op    = dy ? BMP_RLE_OP::RLE_SKIP : BMP_RLE_OP::RLE_RUN;
+            reader.rle_skip  = dy;
+            reader.rle_count = dy ? (uint16_t)(reader.rle_x + dx) : dx;
+            reader.rle_value = 0;
+        } break;
+        default: { // Absolute run - padded to 16bit:
+            uint16_t bytes = this->definition.info_header.bpp == 4 ? (b1 + 1) / 2 : b1;
+            reader.rle_op    = BMP_RLE_OP::RLE_ABSOLUTE;
+            reader.rle_count = b1;
+            reader.rle_pad   = bytes & 0x1;
+        }
+    }
+}
+
+/**
+ * @brief pulls the next palette index from the RLE stream.
+ * 
+ * @param reader - the reader state.
+ * @return uint8_t - the palette index.
+ */
+uint8_t SIKTEC_EPD_BITMAP::readRleIndex(bmp_row_reader_t &reader) {
+    for (;;) {
+        if (reader.rle_op == BMP_RLE_OP::RLE_SKIP || reader.rle_op == BMP_RLE_OP::RLE_END) {
+            reader.rle_x++;
+            return 0;
+        }
+        if (reader.rle_count) {
+            uint8_t index;
+            reader.rle_count--;
+            reader.rle_x++;
+            if (reader.rle_op == BMP_RLE_OP::RLE_ABSOLUTE && (this->definition.info_header.bpp == 8 || reader.rle_phase == 0)) {
+                reader.rle_value = this->readRowByte(reader);
+            }
+            if (this->definition.info_header.bpp == 4) {
+                index = (reader.rle_value >> BITMAP_4BPP_SHIFT[reader.rle_phase]) & 0x0F;
+                reader.rle_phase ^= 1;
+            } else {
+                index = reader.rle_value;
+            }
+            if (reader.rle_op == BMP_RLE_OP::RLE_ABSOLUTE && reader.rle_count == 0 && reader.rle_pad) {
+                this->readRowByte(reader);
+            }
+            return index;
+        }
+        //Nothing more to decode in this line:
+        if (reader.rle_x >= (uint32_t)this->width()) {
+            reader.rle_x++;
+            return 0;
+        }
+        this->rleParseOp(reader);
+    }
+}
+
+/**
+ * @brief consumes the RLE stream up to the start of the next line.
+ * 
+ * @param reader - the reader state.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::rleAdvanceLine(bmp_row_reader_t &reader) {
+    for (;;) {
+        if (reader.rle_op == BMP_RLE_OP::RLE_END) 
+            break;
+        if (reader.rle_op == BMP_RLE_OP::RLE_SKIP) {
+            //Landing line of a delta starts with a zero run:
+            if (--reader.rle_skip == 0) 
+                reader.rle_op = BMP_RLE_OP::RLE_RUN;
+            break;
+        }
+        if (reader.rle_count) {
+            this->readRleIndex(reader);
+            continue;
+        }
+        this->rleParseOp(reader);
+        //Encoders that omit the end of line escape - wrap to the next line:
+        if (reader.rle_x >= (uint32_t)this->width() 
+            && (reader.rle_op == BMP_RLE_OP::RLE_RUN || reader.rle_op == BMP_RLE_OP::RLE_ABSOLUTE)
+        ) break;
+    }
+    reader.rle_line++;
+    reader.rle_x = 0;
+}
+
+/**
+ * @brief pulls and decodes the next pixel of the current row.
  * 
- * @param bitmap_read - The read operation definition
- * @param x           - The requested x - column (from left)
- * @param y           - The requested y - row (from top)
- * @param filter      - apply a filter to the pixel. 
+ * @param reader - the reader state.
+ * @param filter - apply a filter to the pixel. 
  * @return colorBits_t - pixel color bitfield
  */
-colorBits_t SIKTEC_EPD_BITMAP::getBitmapPixel(const bmp_read_definition_t bitmap_read, const int16_t x, const int16_t y, BITMAP_FILTER_IMPLEMENTATION *filter) {
-
-    uint32_t pixels = 0; //read buffer
-    uint32_t row = bitmap_read.start_row + y;
-    uint32_t col = bitmap_read.start_col + x;
-    uint32_t address = bitmap_read.start_row_address + y * bitmap_read.row_bit_size;
-
-    //Point file to pixel array at start of row:
-    if (this->definition.info_header.bpp == 1) {
-        // TODO: Implement this
-        return 0;
-    } else if (this->definition.info_header.bpp == 4) {
-        // TODO: Implement this
-        return 0;
-    } else if (this->definition.info_header.bpp == 8) {
-        address += x;
-        this->seekSet(address + bitmap_read.column_offset_bytes);
-        //We assume its an index
-        uint8_t pixel1 = this->read8();
-        return this->pixelColorProccess((colorBits_t)(pixel1 < this->definition.palette_size ? this->definition.palette[pixel1] : 0xFFFF),  filter);
-    } else if (this->definition.info_header.bpp == 16) {
-        address += x * 2;
-        this->seekSet(address + bitmap_read.column_offset_bytes);
-        //We assume RGB 565 as the color: 00000 000000 00000
-        uint16_t pixel1 = this->read16();
-        return this->pixelColorProccess(pixel1, filter);
-    } else if (this->definition.info_header.bpp == 24) {
-        address += x * 3;
-        this->seekSet(address + bitmap_read.column_offset_bytes);
-        //We assume RGB 888 as the color: 00000000 00000000 00000000
-        uint32_t pixel1 = this->read24();
-        return this->pixelColorProccess(pixel1, filter);
-    } else if (this->definition.info_header.bpp == 32) {
-        address += x * 4;
-        this->seekSet(address + bitmap_read.column_offset_bytes);
-        //We assume ARGB 8888 as the color: 00000000 00000000 00000000 00000000
-        uint32_t pixel1 = this->read32();
-        return this->pixelColorProccess(pixel1, filter);
+colorBits_t SIKTEC_EPD_BITMAP::readRowPixel(bmp_row_reader_t &reader, BITMAP_FILTER_IMPLEMENTATION *filter) {
+    switch (this->definition.info_header.bpp) {
+        case 1:
+        case 4:
+        case 8: {
+            uint8_t pixel1 = this->readRowIndex(reader);
+            if (pixel1 < reader.palette_lut_size) {
+                return reader.palette_lut[pixel1];
+            }
+            return this->pixelColorProccess((colorBits_t)(pixel1 < this->definition.palette_size ? this->definition.palette[pixel1] : 0xFFFF),  filter);
+        }
+        case 16: {
+            uint16_t pixel1 = this->readRowByte(reader);
+            pixel1 |= (uint16_t)this->readRowByte(reader) << 8;
+            return this->bitfieldsColorProccess(pixel1, filter);
+        }
+        case 24: {
+            //BGR stored - RGB 888 as the color: 00000000 00000000 00000000
+            uint32_t pixel1 = this->readRowByte(reader);
+            pixel1 |= (uint32_t)this->readRowByte(reader) << 8;
+            pixel1 |= (uint32_t)this->readRowByte(reader) << 16;
+            return this->pixelColorProccess(pixel1, filter);
+        }
+        case 32: {
+            uint32_t pixel1 = this->readRowByte(reader);
+            pixel1 |= (uint32_t)this->readRowByte(reader) << 8;
+            pixel1 |= (uint32_t)this->readRowByte(reader) << 16;
+            pixel1 |= (uint32_t)this->readRowByte(reader) << 24;
+            return this->bitfieldsColorProccess(pixel1, filter);
+        }
     }
     return 0;
 }
 
+/**
+ * @brief opens the bitmap for a scaled draw - the read definition covers the whole bitmap 
+ * and the output size is clamped to it (downscale only).
+ * 
+ * @param scaler            - the scaler state to initialize.
+ * @param bmp_read          - the read definition to fill.
+ * @param out_width         - the output width.
+ * @param out_height        - the output height - 0 keeps the aspect ratio.
+ * @param scale             - the downscale method.
+ * @param reloadDefinition  - whether to reload definition or not.
+ * @return EPD_BITMAP_STATUS VALID when the file is open and the scaler ready.
+ */
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::beginScaledDraw(
+    bmp_scaler_t &scaler, bmp_read_definition_t &bmp_read, 
+    uint32_t out_width, uint32_t out_height, BITMAP_SCALE scale, bool reloadDefinition
+) {
+    //Reload the header? only if changes could have been done....
+    if (reloadDefinition) {
+        this->releaseDefinition();
+        this->loadDefinition();
+    }
+    if (!this->isValid()) {
+        return this->bitmapStatus();
+    }
+    if (!this->supportedCompression()) {
+        return EPD_BITMAP_STATUS::NOT_IMPLEMENTED; 
+    }
+    uint32_t src_width  = this->width();
+    uint32_t src_height = this->height();
+    if (out_width == 0 || out_width > src_width) {
+        out_width = src_width;
+    }
+    if (out_height == 0) {
+        out_height = (src_height * out_width + src_width / 2) / src_width;
+    }
+    if (out_height == 0) {
+        out_height = 1;
+    } else if (out_height > src_height) {
+        out_height = src_height;
+    }
+    scaler.scale        = scale;
+    scaler.out_width    = out_width;
+    scaler.out_height   = out_height;
+    scaler.rows_read    = 0;
+    scaler.next_out     = -1;
+    if (scale == BITMAP_SCALE::SCALE_BOX) {
+        scaler.sums   = new uint32_t[out_width * 3];
+        scaler.counts = new uint16_t[out_width];
+        if (scaler.sums == nullptr || scaler.counts == nullptr) {
+            this->endScaledDraw(scaler);
+            return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+        }
+        //Source columns per output column - same stepping as scaleNextRow:
+        memset(scaler.counts, 0, out_width * sizeof(uint16_t));
+        uint32_t ox = 0, acc = 0;
+        for (uint32_t sx = 0; sx < src_width; ++sx) {
+            scaler.counts[ox]++;
+            acc += out_width;
+            if (acc >= src_width) {
+                acc -= src_width;
+                ++ox;
+            }
+        }
+    }
+    if (!this->openBitmapFile()) {
+        this->definition.status = EPD_BITMAP_STATUS::ERROR_READ_FILE;
+        this->endScaledDraw(scaler);
+        return EPD_BITMAP_STATUS::ERROR_READ_FILE;
+    }
+    bmp_read = this->prepareBitmapReadDefinition(0, 0, src_width, src_height);
+    return EPD_BITMAP_STATUS::VALID;
+}
+
+/**
+ * @brief pulls the source rows of the next output row (in the reader order) and returns 
+ * the raw output colors - no filter is applied.
+ * SCALE_BOX averages the source pixels of each output pixel, SCALE_NEAREST decodes the 
+ * sampled rows only - the others are skipped by the reader.
+ * 
+ * @param reader    - the reader state.
+ * @param bmp_read  - the read definition.
+ * @param scaler    - the scaler state.
+ * @param out       - the output row colors - out_width entries.
+ * @return int32_t the output row (from top) or -1 when there are no more rows.
+ */
+int32_t SIKTEC_EPD_BITMAP::scaleNextRow(bmp_row_reader_t &reader, const bmp_read_definition_t &bmp_read, bmp_scaler_t &scaler, colorBits_t *out) {
+
+    uint32_t src_width  = bmp_read.read_width;
+    uint32_t src_height = bmp_read.read_height;
+    uint32_t out_width  = scaler.out_width;
+    uint32_t out_height = scaler.out_height;
+
+    if (scaler.scale == BITMAP_SCALE::SCALE_NEAREST) {
+        if (scaler.next_out < 0 && scaler.rows_read == 0) {
+            scaler.next_out = reader.row_direction > 0 ? 0 : (int32_t)out_height - 1;
+        }
+        while (scaler.next_out >= 0 && scaler.next_out < (int32_t)out_height && scaler.rows_read < src_height) {
+            uint32_t src_row = reader.row_direction > 0 ? scaler.rows_read : src_height - 1 - scaler.rows_read;
+            scaler.rows_read++;
+            //The source row at the center of the output row - the others are not read:
+            if (src_row != ((2 * (uint32_t)scaler.next_out + 1) * src_height) / (2 * out_height)) {
+                this->skipBitmapRow(reader, bmp_read);
+                continue;
+            }
+            if (!this->nextBitmapRow(reader, bmp_read)) 
+                return -1;
+            //Sampled columns are stepped with an error accumulator - centers of the output columns:
+            uint32_t den    = 2 * out_width;
+            uint32_t sample = src_width / den,      rem  = src_width % den;
+            uint32_t step   = 2 * src_width / den,  step_rem = 2 * src_width % den;
+            for (uint32_t sx = 0, c = 0; c < out_width; ++sx) {
+                colorBits_t pixel1 = this->readRowPixel(reader, nullptr);
+                if (sx != sample) 
+                    continue;
+                out[c++] = pixel1;
+                sample  += step;
+                rem     += step_rem;
+                if (rem >= den) {
+                    rem -= den;
+                    ++sample;
+                }
+            }
+            int32_t out_row = scaler.next_out;
+            scaler.next_out += reader.row_direction;
+            return out_row;
+        }
+        return -1;
+    }
+
+    //Box - accumulate all the source rows of the output row:
+    if (scaler.rows_read >= src_height) 
+        return -1;
+    uint32_t src_row = reader.row_direction > 0 ? scaler.rows_read : src_height - 1 - scaler.rows_read;
+    uint32_t out_row = src_row * out_height / src_height;
+    uint32_t rows_in = 0;
+    memset(scaler.sums, 0, out_width * 3 * sizeof(uint32_t));
+    while (scaler.rows_read < src_height) {
+        src_row = reader.row_direction > 0 ? scaler.rows_read : src_height - 1 - scaler.rows_read;
+        if (src_row * out_height / src_height != out_row || !this->nextBitmapRow(reader, bmp_read)) 
+            break;
+        scaler.rows_read++;
+        rows_in++;
+        uint32_t  ox  = 0, acc = 0;
+        uint32_t *sum = scaler.sums;
+        for (uint32_t sx = 0; sx < src_width; ++sx) {
+            colorBits_t pixel1 = this->readRowPixel(reader, nullptr);
+            if (bitmap_color_result == BITMAP_COLOR_MODE::COLOR565) {
+                sum[0] += pixel1 >> 11;
+                sum[1] += (pixel1 >> 5) & 0x3F;
+                sum[2] += pixel1 & 0x1F;
+            } else {
+                sum[0] += (pixel1 >> 16) & 0xFF;
+                sum[1] += (pixel1 >> 8) & 0xFF;
+                sum[2] += pixel1 & 0xFF;
+            }
+            acc += out_width;
+            if (acc >= src_width) {
+                acc -= src_width;
+                ++ox;
+                sum += 3;
+            }
+        }
+    }
+    if (!rows_in) {
+        return -1;
+    }
+    for (uint32_t c = 0; c < out_width; ++c) {
+        uint32_t n = (uint32_t)scaler.counts[c] * rows_in;
+        uint32_t R = (scaler.sums[c * 3]     + n / 2) / n;
+        uint32_t G = (scaler.sums[c * 3 + 1] + n / 2) / n;
+        uint32_t B = (scaler.sums[c * 3 + 2] + n / 2) / n;
+        if (bitmap_color_result == BITMAP_COLOR_MODE::COLOR565) {
+            out[c] = (colorBits_t)((R << 11) | (G << 5) | B);
+        } else {
+            out[c] = (colorBits_t)((R << 16) | (G << 8) | B);
+        }
+    }
+    return (int32_t)out_row;
+}
+
+/**
+ * @brief releases the scaler accumulators and closes the file.
+ * 
+ * @param scaler - the scaler state.
+ * @return void
+ */
+void SIKTEC_EPD_BITMAP::endScaledDraw(bmp_scaler_t &scaler) {
+    delete[] scaler.sums;
+    delete[] scaler.counts;
+    scaler.sums   = nullptr;
+    scaler.counts = nullptr;
+    if (this->file.isOpen()) {
+        this->file.close();
+    }
+}
+
 /**
  * @brief Will parse and traverse the pixel array and draw them on the given EPD.
+ * Handles uncompressed, bitfields and RLE pixel arrays through the row reader.
  * 
  * @param epd_x         uint32_t the top-left X position on the EPD.
  * @param epd_y         uint32_t the top-left Y position on the EPD.
@@ -960,7 +2616,7 @@ colorBits_t SIKTEC_EPD_BITMAP::getBitmapPixel(const bmp_read_definition_t bitmap
  * @param kernel        translate_color - the kernel function pointer.
  * @return void 
  */
-void SIKTEC_EPD_BITMAP::proccessUncompressed(
+void SIKTEC_EPD_BITMAP::proccessPixelArray(
     uint32_t epd_x, uint32_t epd_y, 
     const bmp_read_definition_t bitmap_read,
     SIKTEC_EPD *epd,
@@ -968,104 +2624,33 @@ void SIKTEC_EPD_BITMAP::proccessUncompressed(
 ) {
 
     //We assume file is open -> this can be called only from draw which handles the file before.
+    //Rows are streamed in file order so the file is read strictly forward:
+    bmp_row_reader_t reader;
+    this->beginRowReader(reader, bitmap_read, true);
+    this->prefilterPalette(reader, bitmap_read, filter);
     int16_t epd_col      = (int16_t)epd_x;
-    int16_t epd_row      = (int16_t)epd_y + bitmap_read.read_height - 1;
-    uint32_t pixels      = 0; //read buffer
-    uint32_t address     = bitmap_read.start_row_address;
+    int16_t epd_row      = (int16_t)(reader.row_direction > 0 ? epd_y : epd_y + bitmap_read.read_height - 1);
+    bool    positioned   = filter != nullptr && filter->position_dependent;
 
-    for (uint32_t r = 0; r < bitmap_read.read_height; ++r, address += bitmap_read.row_bit_size) {
+    while (this->nextBitmapRow(reader, bitmap_read)) {
         #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
-            PRINT_DEBUG_BUFFER("\n Row[%d,%ld]", r, (long)bitmap_read.row_bit_size);
+            PRINT_DEBUG_BUFFER("\n Row[%d,%ld]", epd_row - (int16_t)epd_y, (long)bitmap_read.row_bit_size);
         #endif
-
-        this->seekSet(address + bitmap_read.column_offset_bytes);
-        
-        for (uint32_t c = 0; c < bitmap_read.read_width; c += bitmap_read.pixels_per_iteration) {
-            //Point file to pixel array at start of row:
-            if (this->definition.info_header.bpp == 1) {
-                pixels = this->read8();
-                for (uint8_t p = bitmap_read.column_skip_bytes; p < bitmap_read.pixels_per_iteration; ++p) {
-                    uint8_t pixel1 = (pixels & ((uint32_t)1 << (bitmap_read.pixels_per_iteration-p-1))) != 0 ? 1 : 0;
-                    epd->drawPixel(
-                        epd_col++, epd_row, 
-                        this->pixelColorProccess(
-                            //NOTE: shlomi - added this for security, in case the file (pixel array is curoptted) we want to avoid reading from undefined palette memory
-                            (colorBits_t)(pixel1 < this->definition.palette_size ? this->definition.palette[pixel1] : 0xFFFF), 
-                            filter
-                        )
-                    );
-                    #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
-                        PRINT_DEBUG_BUFFER(" %3d", pixel1);
-                    #endif
-                }
-            } else if (this->definition.info_header.bpp == 4) {
-                pixels = this->read8();
-                for (int8_t p = bitmap_read.pixels_per_iteration - 1 - bitmap_read.column_skip_bytes; p >= 0; --p) { //Int8_t is important here uint8_t will cause an infinite loop
-                    uint8_t pixel1 = (pixels >> (4 * p)) & 0xF;
-                    epd->drawPixel(
-                        epd_col++, epd_row, 
-                        this->pixelColorProccess(
-                            (colorBits_t)(pixel1 < this->definition.palette_size ? this->definition.palette[pixel1] : 0xFFFF), 
-                            filter
-                        )
-                    );
-                    #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
-                        PRINT_DEBUG_BUFFER(" %3d", pixel1);
-                    #endif
-                }
-            } else if (this->definition.info_header.bpp == 8) {
-                uint8_t pixel1 = this->read8();
-                epd->drawPixel(
-                    epd_col++, epd_row, 
-                    this->pixelColorProccess(
-                        (colorBits_t)(pixel1 < this->definition.palette_size ? this->definition.palette[pixel1] : 0xFFFF), 
-                        filter
-                    )
-                );
-                #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
-                    PRINT_DEBUG_BUFFER(" %3d", pixel1);
-                #endif
-            } else if (this->definition.info_header.bpp == 16) {
-                //We assume RGB 565 as the color:                                   
-                // 00000 000000 00000
-                uint16_t pixel1 = this->read16();
-                epd->drawPixel(
-                    epd_col++, epd_row, 
-                    this->pixelColorProccess(pixel1, filter)
-                );
-                #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
-                    PRINT_DEBUG_BUFFER(" %3d", pixel1);
-                #endif
-            } else if (this->definition.info_header.bpp == 24) {
-                //We assume RGB 888 as the color:
-                // 00000000 00000000 00000000
-                uint32_t pixel1 = this->read24();
-                epd->drawPixel(
-                    epd_col++, epd_row, 
-                    this->pixelColorProccess(pixel1, filter)
-                );
-                #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
-                    PRINT_DEBUG_BUFFER(" %3d", pixel1);
-                #endif
-            } else if (this->definition.info_header.bpp == 32) {
-                //We assume ARGB 8888 as the color:
-                // 00000000 00000000 00000000 00000000
-                uint32_t pixel1 = this->read32();
-                epd->drawPixel(
-                    epd_col++, epd_row, 
-                    this->pixelColorProccess(pixel1, filter)
-                );
-                #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
-                    PRINT_DEBUG_BUFFER(" %3d", pixel1);
-                #endif
+        for (uint32_t c = 0; c < bitmap_read.read_width; ++c) {
+            if (positioned) {
+                filter->position(epd_col, epd_row);
             }
+            colorBits_t pixel1 = this->readRowPixel(reader, filter);
+            epd->drawPixel(epd_col++, epd_row, pixel1);
+            #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
+                PRINT_DEBUG_BUFFER(" %3d", pixel1);
+            #endif
         }
-        
-        //FUTURE: handle flipped pixel array TOP to BOTTOM....
         //Next epd row for drawing:
-        epd_row--; 
+        epd_row += reader.row_direction; 
         epd_col = (int16_t)epd_x;
     }
+    this->endRowReader(reader);
     #if SIKTEC_EPD_DEBUG_BITMAP_PIXELS
         Serial.println();
     #endif
@@ -1322,6 +2907,12 @@ void SIKTEC_EPD_BITMAP::read32(uint32_t *output, const size_t length) {
                 );
             }
         }
+        if (this->definition.info_header.bpp == 16 || this->definition.info_header.bpp == 32) {
+            PRINT_DEBUG_BUFFER("    Masks R/G/B/A : %#lX %#lX %#lX %#lX\n",
+                (unsigned long)this->definition.bitfields.masks[0], (unsigned long)this->definition.bitfields.masks[1],
+                (unsigned long)this->definition.bitfields.masks[2], (unsigned long)this->definition.bitfields.masks[3]
+            );
+        }
         PRINT_DEBUG_BUFFER("    Palette Size: [%ld]\n", (long)this->definition.palette_size);
         if (this->definition.palette_size && this->definition.palette != nullptr) {
             //Colors are stored on the lib side as ARGB
@@ -1350,21 +2941,23 @@ void SIKTEC_EPD_BITMAP::read32(uint32_t *output, const size_t length) {
 #endif
 
 #if SIKTEC_EPD_DEBUG_BITMAP_DITHER
-    void SIKTEC_EPD_BITMAP::printDitherBuffer(const uint16_t buffer, int16_t *ram_buffer,  SIKTEC_EPD *epd, const uint16_t width) {
-        colorBits_t bmpColorPixel;
-        uint8_t color_buf[2];
-        Serial.println("S---- DITHER BUF");
-        for (uint16_t row = 0; row < 2; ++row) {
-            for (uint16_t col = 0; col < width; ++col) {
-                if (ram_buffer == nullptr) {
+    void SIKTEC_EPD_BITMAP::printDitherBuffer(const bmp_diffusion_t &diffusion, SIKTEC_EPD *epd) {
+        int16_t error;
+        Serial.println("S---- DITHER ERROR ROWS");
+        for (uint8_t r = 0; r < diffusion.rows; ++r) {
+            uint16_t offset = ((diffusion.first + r) % diffusion.rows) * diffusion.stride + DITHER_KERNEL_MAX_REACH * diffusion.channels;
+            for (uint16_t col = 0; col < diffusion.width * diffusion.channels; ++col) {
+                if (diffusion.in_sram) {
                     // From sram:
-                    epd->getSramArrayBufferElement(buffer, col + row * width, color_buf, 1);
-                    bmpColorPixel = (color_buf[0] << 8) | color_buf[1];
+                    epd->getSramArrayBufferElement(diffusion.sram_buffer, offset + col, (uint8_t *)&error, 1);
+                } else if (diffusion.compact) {
+                    // From the compact ram:
+                    error = diffusion.ram_compact[offset + col];
                 } else {
                     // From ram:
-                    bmpColorPixel = ram_buffer[col + row * width];
+                    error = diffusion.ram_buffer[offset + col];
                 }
-                PRINT_DEBUG_BUFFER("% 7d ", bmpColorPixel);
+                PRINT_DEBUG_BUFFER("% 7d ", error);
             }
             Serial.println();
         }
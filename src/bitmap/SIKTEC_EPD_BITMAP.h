@@ -1,6 +1,6 @@
 /******************************************************************************/
 // Created by: SIKTEC.
-// Release Version : 1.0.5
+// Release Version : 1.0.6
 // Creation Date: 2022-04-12
 // Copyright 2022, SIKTEC. 
 /******************************************************************************/
@@ -27,10 +27,32 @@
     -> Filters and Dithering procedure.
     -> Multiple formats supported.
 
+1.0.6:
+    -> Rows are streamed sequentially through a buffered row reader.
+    -> 1 / 4 bpp bitmaps are supported by all draw paths (including dithering).
+    -> 16 / 32 bpp channels are decoded with the BI_BITFIELDS masks (RGB555, RGB565, XRGB...).
+    -> getBitmapDefinition(true) allocations are released with freeBitmapDefinition - ERROR_MEMORY on failed allocations.
+    -> RLE8 / RLE4 compressed bitmaps are streamed (delta and end of line escapes included).
+
+    -> Top-down bitmaps (negative height) are drawn in the correct orientation.
+    -> Palettized bitmaps run the filter once per palette entry (per draw).
+    -> Parsed definitions are shared across instances with an LRU cache (path, size, modified).
+    -> reloadDefinition no longer leaks the previous palette.
+
+    -> Sprite sessions - the sheet stays open and batches read each sheet row once.
+    -> Cached sprites (SIKTEC_EPD_SPRITE_CACHE) - decoded once to bitplanes in SRAM / RAM and blitted.
+    -> Streaming downscale (drawBitmapScaled) - box filter / nearest neighbour with O(output width) memory.
+    -> Export to pre-packed .epd images (SIKTEC_EPD_IMAGE) - filtered once, loaded with bulk copies.
+    -> Error diffusion engine - multi row kernels (Jarvis, Stucki, Burkes, Sierra, Atkinson) on a ring of error rows.
+    -> Ordered dithering (Bayer / blue noise masks) - stateless position dependent filters in the streaming paths.
+    -> Serpentine dithering and strips mode - wide bitmaps are dithered in vertical strips with carried edge error.
+    -> DITHER_BWR - color error diffusion to the tri-color panels palette (packed RGB error rows).
+    -> Compact (int8) RAM error rows for the dither filters when the values range permits.
+    -> colorDistance compares squared integer distances (no sqrt) on precomputed color map channels - optional WEIGHTED metric.
+    -> Color LUT (BITMAP_COLOR_LUT) - shared 3D closest color table built by setColorMap, kept in RAM or SRAM (RAM size capped per board - BITMAP_COLOR_LUT_MAX_RAM).
+    -> drawBitmap<FilterT> - row loops instantiated per filter / board type and bpp (kernel and drawPixel called directly).
+
 Future:
-    -> //TODO: implement reversed array bitmaps.
-    -> //TODO: implement dithering with 1 - 8 bpp bitmaps.
-    -> //TODO: create bitmap export procedure. 
 *******************************************************************************/
 
 
@@ -45,6 +67,8 @@ Future:
 #include <SdFat.h>
 #include <SIKTEC_EPD.h>
 #include "SIKTEC_BITMAP_FILTERS.h"
+#include "SIKTEC_EPD_IMAGE.h"
+#include "SIKTEC_EPD_SPRITE_CACHE.h"
 
 #ifndef SIKTEC_EPD_DEBUG_BITMAP 
     #define SIKTEC_EPD_DEBUG_BITMAP 0
@@ -65,12 +89,30 @@ Future:
     #define SPI_SCK_KHZ(speedKhz) SPISettings(1000UL * speedKhz, MSBFIRST, SPI_MODE0) //get the speed in KHz
 #endif
 
+#ifndef SIKTEC_EPD_BITMAP_READ_BUFFER
+    #define SIKTEC_EPD_BITMAP_READ_BUFFER 32 // bytes pulled from the SD per read call while streaming rows
+#endif
+
+#ifndef SIKTEC_EPD_BITMAP_DEF_CACHE
+    #if defined(__AVR__)
+        #define SIKTEC_EPD_BITMAP_DEF_CACHE 0 // parsed definitions shared across instances - 0 disables
+    #else
+        #define SIKTEC_EPD_BITMAP_DEF_CACHE 8 // parsed definitions shared across instances - 0 disables
+    #endif
+#endif
+
+#ifndef BITMAP_DITHER_SEGMENT
+    #define BITMAP_DITHER_SEGMENT 32 // columns per error rows window when the diffusion rows are kept in SRAM
+#endif
+
 #define BITMAP_TYPE_BM 0x4D42 // 0x4D42 ASCII 'BM' is the Windows BMP signature We support.
 #define BITMAP_FILEHEADER_SIZE 14
 
 
 namespace SIKtec {
 
+class SIKTEC_EPD_SPRITE_CACHE; // included after this header when SIKTEC_EPD_SPRITE_CACHE.h comes first
+
 /**
  * @brief different header types and there sizes in bytes
  */
@@ -85,6 +127,28 @@ enum BMP_VARIANT {
     BITMAPV5HEADER_124      = 124  
 };
 
+/**
+ * @brief compression methods as defined in the info header.
+ */
+enum BMP_COMPRESSION {
+    BI_RGB              = 0,
+    BI_RLE8             = 1,
+    BI_RLE4             = 2,
+    BI_BITFIELDS        = 3,
+    BI_ALPHABITFIELDS   = 6
+};
+
+/**
+ * @brief the RLE stream decoder operations (internal state of the row reader).
+ */
+enum BMP_RLE_OP : uint8_t {
+    RLE_NONE,
+    RLE_RUN,
+    RLE_ABSOLUTE,
+    RLE_SKIP,
+    RLE_END
+};
+
 /**
  * @brief BITMAP status flag returned from various methods 
  */
@@ -97,7 +161,9 @@ enum EPD_BITMAP_STATUS {
     ERROR_READ_FILE,
     ERROR_FILE_SIZE,
     COMPRESSION_NOT_SUPPORTED,
-    NOT_IMPLEMENTED
+    NOT_IMPLEMENTED,
+    ERROR_WRITE_FILE,
+    ERROR_MEMORY
 };
 
 /**
@@ -110,9 +176,21 @@ enum BITMAP_FILTER {
     QUANTIZE,
     DITHER_BW,
     DITHER_GRAY4,
+    ORDERED_BW,
+    ORDERED_BWR,
+    ORDERED_GRAY4,
+    DITHER_BWR,
     NONE
 };
 
+/**
+ * @brief Downscale methods of drawBitmapScaled 
+ */
+enum BITMAP_SCALE {
+    SCALE_NEAREST,  // samples the source pixel at the center of each output pixel
+    SCALE_BOX       // averages all the source pixels covered by each output pixel
+};
+
 /**
  * @brief the file header layout shared among all types. 
  */
@@ -157,6 +235,17 @@ typedef struct BMPInfoHeader {
 } bmp_info_header_t;
 #pragma pack(pop)
 
+/**
+ * @brief The channel masks of 16 / 32 bpp bitmaps and the precomputed decode tables.
+ * A channel is decoded with: scale[c][(pixel >> shift[c]) & mask[c]]
+ */
+typedef struct BMPBitfields {
+    uint32_t masks[4]   = { 0, 0, 0, 0 };             // R, G, B, A masks as defined in the file
+    uint8_t  shift[3]   = { 0, 0, 0 };                // R, G, B right shift before the lookup
+    uint8_t  mask[3]    = { 0, 0, 0 };                // R, G, B mask after the shift
+    uint8_t  *scale[3]  = { nullptr, nullptr, nullptr }; // R, G, B tables to the result channel depth - single allocation (createPalette only)
+} bmp_bitfields_t;
+
 /**
  * @brief A struct that wraps the bitmap minimal required info. 
  */
@@ -168,9 +257,24 @@ typedef struct BMPDefinition {
     bmp_info_header_t   info_header;
     uint32_t            palette_size = 0;
     colorBits_t         *palette = nullptr; //BMP format on SD is BGRA this will flip and store ARGB888 or RGB565
+    bmp_bitfields_t     bitfields; // 16 / 32 bpp channels decoding
 } bmp_def_t;
 
 
+/**
+ * @brief A cached bitmap definition shared by all the instances of the same file.
+ * The palette and bitfields tables are owned by the entry while it's cached.
+ */
+typedef struct BMPDefinitionCacheEntry {
+    char        *path       = nullptr;  // the file name used as key - nullptr when free or detached
+    uint32_t    size        = 0;        // file size when parsed
+    uint32_t    modified    = 0;        // last write date << 16 | last write time when parsed
+    uint32_t    last_used   = 0;        // LRU tick
+    uint16_t    refs        = 0;        // instances currently using the definition
+    bmp_def_t   definition;
+    FatFile     file;                   // optional open handle (CACHE_KEEP_OPEN)
+} bmp_def_cache_entry_t;
+
 /**
  * @brief A struct that defines how to read the specific loaded bmp. 
  */
@@ -186,6 +290,84 @@ typedef struct BMPReadDefinition {
     uint32_t column_skip_bytes      = 0;
 } bmp_read_definition_t;
 
+/**
+ * @brief A streaming row reader state - pulls the clipped rows of the pixel array sequentially.
+ */
+typedef struct BMPRowReader {
+    uint32_t row_address    = 0; // file address of the next row to read (column offset included)
+    int32_t  row_step       = 0; // signed bytes step between two consecutive rows
+    int8_t   row_direction  = 1; // 1 -> rows are delivered top to bottom, -1 -> bottom to top
+    uint32_t rows_left      = 0; // rows left to read in the clip window
+    uint32_t row_bytes_left = 0; // bytes of the current row not yet pulled from the file
+    uint8_t  pixel_byte     = 0; // current packed byte of a 1 / 4 bpp row
+    uint8_t  pixel_pos      = 0; // next pixel position within the packed byte
+    uint16_t buffer_pos     = 0;
+    uint16_t buffer_len     = 0;
+    uint8_t  buffer[SIKTEC_EPD_BITMAP_READ_BUFFER];
+    colorBits_t *palette_lut      = nullptr; // palette entries after the filter - per draw
+    uint16_t    palette_lut_size  = 0;
+    //RLE4 / RLE8 stream state:
+    bool     rle            = false;    // the pixel array is an RLE stream
+    uint8_t  rle_op         = BMP_RLE_OP::RLE_NONE;
+    uint8_t  rle_value      = 0;        // encoded run value (RLE4 holds two pixels)
+    uint8_t  rle_phase      = 0;        // RLE4 nibble selector
+    bool     rle_pad        = false;    // absolute run is followed by a padding byte
+    uint16_t rle_count      = 0;        // pixels left in the current run
+    uint16_t rle_skip       = 0;        // lines left to skip (delta / end of line escapes)
+    uint32_t rle_line       = 0;        // current decoded line (from the bottom)
+    uint32_t rle_x          = 0;        // current decoded column
+} bmp_row_reader_t;
+
+/**
+ * @brief A streaming downscaler state - accumulates source rows into output rows.
+ * Columns are mapped with an integer error accumulator (exact for any ratio).
+ */
+typedef struct BMPScaler {
+    BITMAP_SCALE scale      = BITMAP_SCALE::SCALE_BOX;
+    uint32_t out_width      = 0;
+    uint32_t out_height     = 0;
+    uint32_t rows_read      = 0;        // source rows pulled from the reader
+    int32_t  next_out       = -1;       // next sampled output row (nearest)
+    uint32_t *sums          = nullptr;  // R, G, B sums per output column (box)
+    uint16_t *counts        = nullptr;  // source columns per output column (box)
+} bmp_scaler_t;
+
+/**
+ * @brief A single error diffusion tap - the error share of a neighbour.
+ */
+typedef struct BMPDitherTap {
+    uint8_t  row;       // error row - 0 is the current row
+    int8_t   dx;        // column offset from the pixel
+    int16_t  weight;    // error share - weight / divisor << DITHER_KERNEL_SHIFT
+} bmp_dither_tap_t;
+
+/**
+ * @brief An error diffusion state - a ring of error rows (one per kernel row) in RAM or SRAM.
+ * Each row is padded by DITHER_KERNEL_MAX_REACH columns on both sides so the taps never 
+ * need bounds checks - the padding errors are dropped (carried / folded in strips mode).
+ * Color filters keep the channel errors of a column packed together (channels elements per column).
+ */
+typedef struct BMPDiffusion {
+    bmp_dither_tap_t taps[DITHER_KERNEL_MAX_ROWS * DITHER_KERNEL_COLUMNS];
+    uint8_t  tap_count      = 0;
+    uint8_t  reach          = 0;        // the kernel columns reach - the carried edge error columns
+    uint8_t  rows           = 0;        // error rows in the ring
+    uint8_t  first          = 0;        // ring index of the current row
+    uint8_t  channels       = 1;        // error elements per column
+    uint16_t row            = 0;        // rows dithered in this pass
+    uint16_t width          = 0;        // dithered columns
+    uint16_t stride         = 0;        // padded row length in elements
+    bool     serpentine     = false;    // odd rows are dithered right to left
+    uint16_t carry          = 0;        // carried edge error offset (after the ring) - 0 when not in strips mode
+    bool     carry_in       = false;    // the strip adds the edge error of the strip on its left
+    bool     carry_out      = false;    // the strip saves its edge error for the strip on its right
+    bool     in_sram        = false;
+    bool     compact        = false;    // RAM ring of int8 errors - see BITMAP_DITHER_FILTER::setCompactErrors
+    uint16_t sram_buffer    = 0;        // SRAM ring address
+    int16_t  *ram_buffer    = nullptr;  // RAM ring
+    int8_t   *ram_compact   = nullptr;  // RAM ring - compact
+} bmp_diffusion_t;
+
 /**
  * @brief A BMP sprite definition struct. 
  */
@@ -197,9 +379,34 @@ typedef struct BMPSprite {
 } bmp_sprite_t;
 
 
+/**
+ * @brief A single sprite placement in a sprite batch. 
+ */
+typedef struct BMPSpriteDraw {
+    uint16_t index = 0; // the sprite index
+    int16_t  x     = 0; // top-left X position on the EPD
+    int16_t  y     = 0; // top-left Y position on the EPD
+} bmp_sprite_draw_t;
+
+/**
+ * @brief An open sprite session - the file stays open and the palette is filtered once. 
+ */
+typedef struct BMPSpriteSession {
+    bool        active           = false;
+    BITMAP_FILTER_IMPLEMENTATION *filter = nullptr;
+    colorBits_t *palette_lut     = nullptr; // palette entries after the filter - per session
+    uint16_t    palette_lut_size = 0;
+} bmp_sprite_session_t;
+
 /** @brief the kernel function pointer that can be attached as a filter to the drawing methods */
 typedef colorBits_t (*translate_color)(const uint8_t R, const uint8_t G, const uint8_t B);
 
+/** 
+ * @brief the template argument as a non deduced type - the templated draw entry points 
+ * are used only when the types are given explicitly (drawBitmap<FilterT>), other calls keep the virtual API. 
+ */
+template <class T> struct bmp_explicit_t { typedef T type; };
+
 //------------------------------------------------------------------------//
 // SIKTEC_EPD_BITMAP
 //------------------------------------------------------------------------//
@@ -223,6 +430,15 @@ public:
 
     bool exists = false; /**< flag that indicates whether a file exists and fully loaded or not */
 
+    static bool CACHE_KEEP_OPEN; /**< keep the files of cached definitions open - draws skip the FAT lookup */
+
+    static uint32_t cache_hits;   /**< definitions served from the definitions cache */
+
+    static uint32_t cache_misses; /**< definitions parsed from the file */
+
+    /** @brief releases all the cached definitions that are not in use and closes the kept handles */
+    static void clearDefinitionCache();
+
     /** @brief Construct a new siktec epd bitmap::siktec epd bitmap object */
     SIKTEC_EPD_BITMAP(SdFat * sd, FatFile &_file, uint16_t filename_size = 50);
 
@@ -265,6 +481,30 @@ public:
         bool            reloadDefinition = false 
     );
 
+    /** @brief Opens a sprite session - keeps the file open and filters the palette once. */
+    EPD_BITMAP_STATUS beginSpriteSession(BITMAP_FILTER_IMPLEMENTATION *filter);
+
+    /** @brief Draws a single sprite within the open sprite session. */
+    EPD_BITMAP_STATUS drawSprite(uint16_t sprite_index, int16_t epd_x, int16_t epd_y, SIKTEC_EPD *epd);
+
+    /** @brief Draws a batch of sprites - each sheet row is read once for all of its sprites. */
+    EPD_BITMAP_STATUS drawSprites(const bmp_sprite_draw_t *sprites, uint16_t count, SIKTEC_EPD *epd);
+
+    /** @brief Closes the sprite session - releases the file handle and the palette table. */
+    void endSpriteSession();
+
+    /** @brief Draws a sprite through a decoded sprites cache - decoded and filtered once, then blitted. */
+    EPD_BITMAP_STATUS drawCachedSprite(
+        SIKTEC_EPD_SPRITE_CACHE *cache,
+        BITMAP_FILTER_IMPLEMENTATION *filter,
+        uint16_t        sprite_index,
+        int16_t         epd_x,
+        int16_t         epd_y
+    );
+
+    /** @brief the sprite cache key of a sprite - the file identity, filter and index */
+    epd_sprite_key_t spriteKey(const void *filter, uint16_t sprite_index);
+
     /** @brief Draws a bitmap to the given epd object with predefined filters. */
     EPD_BITMAP_STATUS drawBitmap(
         BITMAP_FILTER builtin_filters,
@@ -291,7 +531,21 @@ public:
         bool reloadDefinition = false
     );
     
-    /** @brief Draws the bitmap on the given EPD while applying a dithering algorithm. */
+    /** @brief Draws the bitmap with the kernel of a known filter type inlined in the row loops - drawBitmap<FilterT>(...). */
+    template <class FilterT, class EpdT = SIKTEC_EPD>
+    EPD_BITMAP_STATUS drawBitmap(
+        typename bmp_explicit_t<FilterT>::type *filter,
+        uint32_t epd_x,
+        uint32_t epd_y,
+        typename bmp_explicit_t<EpdT>::type *epd,
+        uint32_t bmp_sc  = 0, // start column
+        uint32_t bmp_sr  = 0, // start row
+        uint32_t bmp_cw  = 0, // clip width 0 means fullwidth
+        uint32_t bmp_ch  = 0, // clip height 0 means fullheight 
+        bool reloadDefinition = false
+    );
+
+    /** @brief Draws the bitmap on the given EPD while applying a dithering algorithm - bottom-up RLE is dithered bottom to top. */
     EPD_BITMAP_STATUS drawBitmapDithered(
         BITMAP_DITHER_FILTER *filter,
         uint32_t epd_x,
@@ -304,28 +558,217 @@ public:
         bool reloadDefinition = false
     );
 
-    /** @brief Return a bitmap definition parsed from the headers */
+    /** @brief Draws the whole bitmap downscaled to the given size - box filter or nearest neighbour. */
+    EPD_BITMAP_STATUS drawBitmapScaled(
+        BITMAP_FILTER_IMPLEMENTATION *filter,
+        uint32_t epd_x,
+        uint32_t epd_y,
+        SIKTEC_EPD *epd,
+        uint32_t out_width,
+        uint32_t out_height = 0, // 0 keeps the aspect ratio
+        BITMAP_SCALE scale  = BITMAP_SCALE::SCALE_BOX,
+        bool reloadDefinition = false
+    );
+
+    /** @brief Draws the whole bitmap downscaled to the given size while applying a dithering algorithm. */
+    EPD_BITMAP_STATUS drawBitmapScaledDithered(
+        BITMAP_DITHER_FILTER *filter,
+        uint32_t epd_x,
+        uint32_t epd_y,
+        SIKTEC_EPD *epd,
+        uint32_t out_width,
+        uint32_t out_height = 0, // 0 keeps the aspect ratio
+        BITMAP_SCALE scale  = BITMAP_SCALE::SCALE_BOX,
+        bool reloadDefinition = false
+    );
+
+    /** @brief Draws the bitmap with a predefined filter and saves the drawn region as an .epd image. */
+    EPD_BITMAP_STATUS exportImage(
+        BITMAP_FILTER builtin_filters,
+        uint32_t epd_x,
+        uint32_t epd_y,
+        SIKTEC_EPD *epd,
+        FatFile &out,
+        uint32_t bmp_sc  = 0, // start column
+        uint32_t bmp_sr  = 0, // start row
+        uint32_t bmp_cw  = 0, // clip width 0 means fullwidth
+        uint32_t bmp_ch  = 0  // clip height 0 means fullheight 
+    );
+
+    /** @brief Draws the bitmap with a custom filter and saves the drawn region as an .epd image. */
+    EPD_BITMAP_STATUS exportImage(
+        BITMAP_FILTER_IMPLEMENTATION *filter,
+        uint32_t epd_x,
+        uint32_t epd_y,
+        SIKTEC_EPD *epd,
+        FatFile &out,
+        uint32_t bmp_sc  = 0, // start column
+        uint32_t bmp_sr  = 0, // start row
+        uint32_t bmp_cw  = 0, // clip width 0 means fullwidth
+        uint32_t bmp_ch  = 0  // clip height 0 means fullheight 
+    );
+
+    /** @brief Draws the bitmap with a dither filter and saves the drawn region as an .epd image. */
+    EPD_BITMAP_STATUS exportImage(
+        BITMAP_DITHER_FILTER *filter,
+        uint32_t epd_x,
+        uint32_t epd_y,
+        SIKTEC_EPD *epd,
+        FatFile &out,
+        uint32_t bmp_sc  = 0, // start column
+        uint32_t bmp_sr  = 0, // start row
+        uint32_t bmp_cw  = 0, // clip width 0 means fullwidth
+        uint32_t bmp_ch  = 0  // clip height 0 means fullheight 
+    );
+
+    /** @brief Return a bitmap definition parsed from the headers - createPalette allocations are owned by the caller */
     bmp_def_t getBitmapDefinition(bool createPalette = false);
 
+    /** @brief releases the palette and decode tables of a definition returned by getBitmapDefinition(true) */
+    static void freeBitmapDefinition(bmp_def_t &def);
+
     #if SIKTEC_EPD_DEBUG_BITMAP
         /** @brief prints to serial the parsed bitmap definition struct */
         void debug_bitmapDefinition();
     #endif
     #if SIKTEC_EPD_DEBUG_BITMAP_DITHER
         /** @brief  dumps to serial the allocated dithering buffer state */
-        void printDitherBuffer(const uint16_t buffer, int16_t *ram_buffer,  SIKTEC_EPD *epd, const uint16_t width);
+        void printDitherBuffer(const bmp_diffusion_t &diffusion, SIKTEC_EPD *epd);
     #endif
     
 private:
+
+    bmp_def_cache_entry_t *cached = nullptr; /**< the shared cache entry of the definition if cached */
+
+    uint32_t file_size = 0; /**< the file size when the definition was loaded */
+
+    uint32_t file_modified = 0; /**< the file last write stamp when the definition was loaded */
+
+    bmp_sprite_session_t session; /**< the open sprite session state */
+
+    /** @brief draws the sprites of a single sheet row - sorted by column */
+    void drawSheetRow(const bmp_sprite_draw_t *sprites, const uint16_t *order, uint16_t count, SIKTEC_EPD *epd);
+
+    /** @brief skips pixels of the current row without decoding them */
+    void skipRowPixels(bmp_row_reader_t &reader, uint32_t pixels);
+
+    /** @brief loads the definition - from the definitions cache when the file didn't change */
+    bool loadDefinition();
+
+    /** @brief releases the definition palette and tables or the cache entry reference */
+    void releaseDefinition();
+
+    /** @brief stores the loaded definition in the definitions cache */
+    void storeDefinition(bmp_def_cache_entry_t *stale, const uint32_t size, const uint32_t modified);
+
+    /** @brief opens the bitmap file for reading - reuses the cached open handle if available */
+    bool openBitmapFile();
+
+    /** @brief saves the region drawn by a draw call as an .epd image */
+    EPD_BITMAP_STATUS saveDrawnImage(
+        EPD_BITMAP_STATUS drawn, uint32_t epd_x, uint32_t epd_y, SIKTEC_EPD *epd, FatFile &out,
+        uint32_t bmp_sc, uint32_t bmp_sr, uint32_t bmp_cw, uint32_t bmp_ch
+    );
     
     /** @brief will return all needed values to define how and where to read the bitmap array based on the given coordinates **/
     bmp_read_definition_t prepareBitmapReadDefinition(const uint32_t bmp_sr, const uint32_t bmp_sc, const uint32_t loadWidth, const uint32_t loadHeight);
 
-    /** @brief return a single pixel color directly from the bitmap **/
-    colorBits_t getBitmapPixel(const bmp_read_definition_t bitmap_read, const int16_t x, const int16_t y, BITMAP_FILTER_IMPLEMENTATION *filter);
+    /** @brief true if the compression method is supported for the bitmap bpp. */
+    bool supportedCompression();
+
+    /** @brief prepares a row reader that walks the clipped rows. */
+    void beginRowReader(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read, const bool file_order = false);
+
+    /** @brief runs the filter once per palette entry and attaches the result table to the reader. */
+    void prefilterPalette(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read, BITMAP_FILTER_IMPLEMENTATION *filter);
+
+    /** @brief releases any memory attached to the row reader. */
+    void endRowReader(bmp_row_reader_t &reader);
+
+    /** @brief moves the row reader to the next row - a single seek per row. */
+    bool nextBitmapRow(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read);
+
+    /** @brief moves the row reader past the next row without reading it. */
+    bool skipBitmapRow(bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read);
+
+    /** @brief pulls a single byte of the current row from the reader buffer. */
+    uint8_t readRowByte(bmp_row_reader_t &reader);
+
+    /** @brief pulls a single byte of the current row - buffered bytes are returned without a call. */
+    inline uint8_t nextRowByte(bmp_row_reader_t &reader) {
+        return reader.buffer_pos < reader.buffer_len ? reader.buffer[reader.buffer_pos++] : this->readRowByte(reader);
+    }
+
+    /** @brief pulls the next palette index of the current row (1, 4, 8 bpp). */
+    uint8_t readRowIndex(bmp_row_reader_t &reader);
+
+    /** @brief parses the next RLE escape / run from the stream. */
+    void rleParseOp(bmp_row_reader_t &reader);
+
+    /** @brief pulls the next palette index from the RLE stream. */
+    uint8_t readRleIndex(bmp_row_reader_t &reader);
+
+    /** @brief consumes the RLE stream up to the start of the next line. */
+    void rleAdvanceLine(bmp_row_reader_t &reader);
+
+    /** @brief pulls and decodes the next pixel of the current row. */
+    colorBits_t readRowPixel(bmp_row_reader_t &reader, BITMAP_FILTER_IMPLEMENTATION *filter);
+
+    /** @brief opens the bitmap for a scaled draw and prepares the scaler. */
+    EPD_BITMAP_STATUS beginScaledDraw(
+        bmp_scaler_t &scaler, bmp_read_definition_t &bmp_read, 
+        uint32_t out_width, uint32_t out_height, BITMAP_SCALE scale, bool reloadDefinition
+    );
+
+    /** @brief pulls the source rows of the next output row and returns the raw output colors. */
+    int32_t scaleNextRow(bmp_row_reader_t &reader, const bmp_read_definition_t &bmp_read, bmp_scaler_t &scaler, colorBits_t *out);
+
+    /** @brief releases the scaler accumulators and closes the file. */
+    void endScaledDraw(bmp_scaler_t &scaler);
+
+    /** @brief prepares the diffusion taps of the filter kernel and allocates the error rows ring. */
+    bool beginDiffusion(bmp_diffusion_t &diffusion, BITMAP_DITHER_FILTER *filter, SIKTEC_EPD *epd, const uint16_t width, const uint16_t height = 0);
+
+    /** @brief clears the error rows ring for a new pass (strip). */
+    void resetDiffusion(bmp_diffusion_t &diffusion, SIKTEC_EPD *epd, const uint16_t width, const bool carry_in, const bool carry_out);
+
+    /** @brief reads / writes consecutive error values of the ring in RAM or SRAM. */
+    void transferDiffusion(bmp_diffusion_t &diffusion, SIKTEC_EPD *epd, const uint16_t index, int16_t *values, const uint16_t count, const bool store);
+
+    /** @brief dithers and draws a single row - the pixels come from the row reader or a decoded line. */
+    void diffuseRow(
+        bmp_diffusion_t &diffusion, BITMAP_DITHER_FILTER *filter, SIKTEC_EPD *epd, 
+        const int16_t epd_x, const int16_t epd_y, 
+        bmp_row_reader_t *reader, const colorBits_t *line = nullptr
+    );
+
+    /** @brief adds the next source pixels to the current error row - split to channels by the filter. */
+    void pullDitherPixels(
+        BITMAP_DITHER_FILTER *filter, const uint8_t channels, 
+        bmp_row_reader_t *reader, const colorBits_t *line, 
+        const uint16_t x, const uint16_t count, int16_t *current
+    );
+
+    /** @brief releases the error rows ring. */
+    void endDiffusion(bmp_diffusion_t &diffusion, SIKTEC_EPD *epd);
+
+    /** @brief clips the region, prepares the read definition and opens the file - shared by the draw entry points. */
+    EPD_BITMAP_STATUS beginDraw(
+        bmp_read_definition_t &bmp_read,
+        uint32_t epd_x, uint32_t epd_y, SIKTEC_EPD *epd,
+        uint32_t bmp_sc, uint32_t bmp_sr, uint32_t bmp_cw, uint32_t bmp_ch, 
+        bool reloadDefinition
+    );
+
+    /** @brief the row loop of drawBitmap<FilterT> - instantiated per filter, board and bpp. */
+    template <class FilterT, class EpdT, uint8_t BPP>
+    void proccessPixelRows(
+        bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read,
+        uint32_t epd_x, uint32_t epd_y, EpdT *epd, FilterT *filter
+    );
 
     /** @brief Will parse and traverse the pixel array and draw them on the given EPD. */
-    void proccessUncompressed(
+    void proccessPixelArray(
         uint32_t epd_x, uint32_t epd_y, 
         const bmp_read_definition_t bitmap_read,
         SIKTEC_EPD *epd,
@@ -338,6 +781,12 @@ private:
     /** @brief Will apply the Filter / Kernel to a parsed pixel and return the color format to use. */
     colorBits_t pixelColorProccess(uint32_t rgb888, BITMAP_FILTER_IMPLEMENTATION *filter = nullptr);
 
+    /** @brief parses the channel masks and builds the bitfields decode tables. */
+    bool prepareBitfields(bmp_def_t &def, const bool createTables);
+
+    /** @brief decodes a 16 / 32 bpp pixel with the bitfields tables and applies the filter. */
+    colorBits_t bitfieldsColorProccess(const uint32_t pixel, BITMAP_FILTER_IMPLEMENTATION *filter = nullptr);
+
     /** @brief Return the bitmap type (Header Format) - Based on the header size. */
     BMP_VARIANT bitmapVariant();
 
@@ -379,4 +828,123 @@ private:
 
 };
 
+//------------------------------------------------------------------------//
+// SIKTEC_EPD_BITMAP templated draw loops
+//------------------------------------------------------------------------//
+
+/**
+ * @brief Draws the bitmap on the given EPD with the filter kernel and the framebuffer write 
+ * called directly (no virtual dispatch per pixel) - the row loop is instantiated per filter 
+ * type, board type and bpp. The types must be given explicitly: drawBitmap<BitmapFilter_QUANT>(...).
+ * NOTE: FilterT::kernel and EpdT::drawPixel are called as named - pass the most derived types 
+ * when they are overridden. Other calls use the virtual drawBitmap (same output).
+ * 
+ * @tparam FilterT  the filter type - a BITMAP_FILTER_IMPLEMENTATION with a kernel.
+ * @tparam EpdT     the board type - defaults to SIKTEC_EPD (the drivers share its drawPixel).
+ * @param filter    FilterT * the filter object pointer.
+ * @param epd_x     uint32_t the top-left X position on the EPD.
+ * @param epd_y     uint32_t the top-left Y position on the EPD.
+ * @param epd       EpdT * the pointer to the epd to draw on.
+ * @param bmp_sc    uint32_t the bitmap starting point X / Column (From Left).
+ * @param bmp_sr    uint32_t the bitmap starting point Y / Row (From Top).
+ * @param bmp_cw    uint32_t The width to draw (clip width) - 0 for full width.
+ * @param bmp_ch    uint32_t The width to draw (clip height) - 0 for full height.
+ * @param reloadDefinition bool default False - whether to reload definition or not.
+ * @return EPD_BITMAP_STATUS  - consider DONE as successfull.
+ */
+template <class FilterT, class EpdT>
+EPD_BITMAP_STATUS SIKTEC_EPD_BITMAP::drawBitmap(
+    typename bmp_explicit_t<FilterT>::type *filter,
+    uint32_t epd_x,
+    uint32_t epd_y,
+    typename bmp_explicit_t<EpdT>::type *epd,
+    uint32_t bmp_sc,
+    uint32_t bmp_sr,
+    uint32_t bmp_cw,
+    uint32_t bmp_ch,
+    bool reloadDefinition
+) {
+    bmp_read_definition_t bmp_read;
+    EPD_BITMAP_STATUS status = this->beginDraw(bmp_read, epd_x, epd_y, epd, bmp_sc, bmp_sr, bmp_cw, bmp_ch, reloadDefinition);
+    if (status != EPD_BITMAP_STATUS::VALID) {
+        return status;
+    }
+    //Rows are streamed in file order - the bpp is resolved once per draw:
+    bmp_row_reader_t reader;
+    this->beginRowReader(reader, bmp_read, true);
+    this->prefilterPalette(reader, bmp_read, filter);
+    switch (this->definition.info_header.bpp) {
+        case 16: this->proccessPixelRows<FilterT, EpdT, 16>(reader, bmp_read, epd_x, epd_y, epd, filter); break;
+        case 24: this->proccessPixelRows<FilterT, EpdT, 24>(reader, bmp_read, epd_x, epd_y, epd, filter); break;
+        case 32: this->proccessPixelRows<FilterT, EpdT, 32>(reader, bmp_read, epd_x, epd_y, epd, filter); break;
+        default: this->proccessPixelRows<FilterT, EpdT, 8>(reader, bmp_read, epd_x, epd_y, epd, filter); 
+    }
+    this->endRowReader(reader);
+    this->file.close();
+    return EPD_BITMAP_STATUS::DONE;
+}
+
+/**
+ * @brief the row loop of drawBitmap<FilterT> - decodes the BPP pixels and calls the kernel 
+ * and drawPixel of the given types directly. Palettized bitmaps (BPP 8 covers 1 / 4 / 8 and RLE) 
+ * draw the prefiltered palette entries.
+ * 
+ * @param reader        the row reader - prepared in file order with the prefiltered palette.
+ * @param bitmap_read   the read definition.
+ * @param epd_x         the top-left X position on the EPD.
+ * @param epd_y         the top-left Y position on the EPD.
+ * @param epd           the board to draw on.
+ * @param filter        the filter to apply.
+ * @return void
+ */
+template <class FilterT, class EpdT, uint8_t BPP>
+void SIKTEC_EPD_BITMAP::proccessPixelRows(
+    bmp_row_reader_t &reader, const bmp_read_definition_t &bitmap_read,
+    uint32_t epd_x, uint32_t epd_y, EpdT *epd, FilterT *filter
+) {
+    const bmp_bitfields_t &bitfields = this->definition.bitfields;
+    int16_t epd_col     = (int16_t)epd_x;
+    int16_t epd_row     = (int16_t)(reader.row_direction > 0 ? epd_y : epd_y + bitmap_read.read_height - 1);
+    bool    positioned  = filter->position_dependent;
+    uint32_t    pixel;
+    colorBits_t color;
+    while (this->nextBitmapRow(reader, bitmap_read)) {
+        for (uint32_t c = 0; c < bitmap_read.read_width; ++c) {
+            if (positioned) {
+                filter->position(epd_col, epd_row);
+            }
+            if (BPP == 8) {
+                uint8_t index = this->readRowIndex(reader);
+                color = index < reader.palette_lut_size 
+                    ? reader.palette_lut[index] 
+                    : this->pixelColorProccess((colorBits_t)(index < this->definition.palette_size ? this->definition.palette[index] : 0xFFFF), filter);
+            } else if (BPP == 24) {
+                //BGR stored - the kernel gets the result color mode channels:
+                uint8_t B8 = this->nextRowByte(reader);
+                uint8_t G8 = this->nextRowByte(reader);
+                uint8_t R8 = this->nextRowByte(reader);
+                color = bitmap_color_result == BITMAP_COLOR_MODE::COLOR565 
+                    ? filter->FilterT::kernel(R8 >> 3, G8 >> 2, B8 >> 3)
+                    : filter->FilterT::kernel(R8, G8, B8);
+            } else {
+                pixel  = this->nextRowByte(reader);
+                pixel |= (uint32_t)this->nextRowByte(reader) << 8;
+                if (BPP == 32) {
+                    pixel |= (uint32_t)this->nextRowByte(reader) << 16;
+                    pixel |= (uint32_t)this->nextRowByte(reader) << 24;
+                }
+                color = filter->FilterT::kernel(
+                    bitfields.scale[0][(pixel >> bitfields.shift[0]) & bitfields.mask[0]],
+                    bitfields.scale[1][(pixel >> bitfields.shift[1]) & bitfields.mask[1]],
+                    bitfields.scale[2][(pixel >> bitfields.shift[2]) & bitfields.mask[2]]
+                );
+            }
+            epd->EpdT::drawPixel(epd_col++, epd_row, color);
+        }
+        //Next epd row for drawing:
+        epd_row += reader.row_direction; 
+        epd_col = (int16_t)epd_x;
+    }
+}
+
 }
\ No newline at end of file
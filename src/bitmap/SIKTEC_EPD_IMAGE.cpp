@@ -0,0 +1,226 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+
+/**  @file SIKTEC_EPD_IMAGE.cpp */
+
+#include "SIKTEC_EPD_IMAGE.h"
+
+namespace SIKtec {
+
+/**
+ * @brief reads the .epd header from the start of the file and validates it.
+ *
+ * @param file      an open FatFile.
+ * @param header    the header to fill.
+ * @return EPD_IMAGE_STATUS IMAGE_DONE if valid.
+ */
+EPD_IMAGE_STATUS SIKTEC_EPD_IMAGE::readHeader(FatFile &file, epd_image_header_t &header) {
+    if (!file.isOpen()) {
+        return EPD_IMAGE_STATUS::IMAGE_ERROR_READ_FILE;
+    }
+    file.rewind();
+    if (file.read(&header, sizeof(epd_image_header_t)) != sizeof(epd_image_header_t)) {
+        return EPD_IMAGE_STATUS::IMAGE_ERROR_READ_FILE;
+    }
+    if (header.type != EPD_IMAGE_TYPE || header.version != EPD_IMAGE_VERSION) {
+        return EPD_IMAGE_STATUS::IMAGE_UNSUPPORTED_TYPE;
+    }
+    uint8_t planes = ((header.planes & EPD_IMAGE_PLANE_BLACK) ? 1 : 0) + ((header.planes & EPD_IMAGE_PLANE_COLOR) ? 1 : 0);
+    if (header.plane_size != (uint32_t)header.columns * header.column_bytes
+        || file.fileSize() < sizeof(epd_image_header_t) + planes * header.plane_size
+    ) {
+        return EPD_IMAGE_STATUS::IMAGE_ERROR_READ_FILE;
+    }
+    return EPD_IMAGE_STATUS::IMAGE_DONE;
+}
+
+/**
+ * @brief the plane byte runs covered by a region.
+ * a region that spans the full raw height is contiguous in the plane - a single run.
+ *
+ * @param epd       the SIKTEC_EPD.
+ * @param header    the image header.
+ * @param run_len   the run length in bytes.
+ * @param runs      number of runs.
+ */
+void SIKTEC_EPD_IMAGE::planeRuns(SIKTEC_EPD *epd, const epd_image_header_t &header, uint32_t &run_len, uint16_t &runs) {
+    if ((uint32_t)header.column_bytes * 8 == epd->rawHeight()) {
+        run_len = header.plane_size;
+        runs    = 1;
+    } else {
+        run_len = header.column_bytes;
+        runs    = header.columns;
+    }
+}
+
+/**
+ * @brief saves a screen region of the framebuffer as an .epd image.
+ * the region is expanded to whole framebuffer bytes vertically (raw coordinates).
+ *
+ * @param epd   the SIKTEC_EPD to read the framebuffer from.
+ * @param out   an open (writable) FatFile - the image is written from the current position.
+ * @param x     the region top-left x coordinate.
+ * @param y     the region top-left y coordinate.
+ * @param w     the region width.
+ * @param h     the region height.
+ * @return EPD_IMAGE_STATUS
+ */
+EPD_IMAGE_STATUS SIKTEC_EPD_IMAGE::save(SIKTEC_EPD *epd, FatFile &out, int16_t x, int16_t y, int16_t w, int16_t h) {
+
+    epd_raw_rect_t rect = epd->getRawRect(x, y, w, h);
+    if (!rect.w || !rect.h) {
+        return EPD_IMAGE_STATUS::IMAGE_OUT_OF_BOUNDS;
+    }
+    if (!out.isOpen()) {
+        return EPD_IMAGE_STATUS::IMAGE_ERROR_WRITE_FILE;
+    }
+
+    epd_image_header_t header;
+    header.planes       = EPD_IMAGE_PLANE_BLACK | (epd->planeSize(EPD_PLANE_COLOR) ? EPD_IMAGE_PLANE_COLOR : 0);
+    header.panel_width  = epd->rawWidth();
+    header.panel_height = epd->rawHeight();
+    header.x            = rect.x;
+    header.y            = rect.y;
+    header.columns      = rect.w;
+    header.column_bytes = rect.h / 8;
+    header.rotation     = epd->getRotation();
+    header.plane_size   = (uint32_t)header.columns * header.column_bytes;
+    if (out.write(&header, sizeof(epd_image_header_t)) != sizeof(epd_image_header_t)) {
+        return EPD_IMAGE_STATUS::IMAGE_ERROR_WRITE_FILE;
+    }
+
+    uint32_t run_len;
+    uint16_t runs;
+    SIKTEC_EPD_IMAGE::planeRuns(epd, header, run_len, runs);
+
+    //Right most column has the lowest offset - the runs are in framebuffer order:
+    uint32_t first = epd->getRawColumnOffset(rect.x + rect.w - 1, rect.y);
+    uint32_t step  = epd->rawHeight() / 8;
+    uint8_t  buffer[SIKTEC_EPD_IMAGE_BUFFER];
+
+    for (uint8_t p = 0; p < 2; p++) {
+        epd_plane_t plane = p ? EPD_PLANE_COLOR : EPD_PLANE_BLACK;
+        if (!(header.planes & (p ? EPD_IMAGE_PLANE_COLOR : EPD_IMAGE_PLANE_BLACK))) {
+            continue;
+        }
+        uint8_t invert = epd->isPlaneInverted(plane) ? 0xFF : 0x00;
+        for (uint16_t r = 0; r < runs; r++) {
+            uint32_t offset = first + r * step;
+            for (uint32_t done = 0; done < run_len; ) {
+                uint16_t len = run_len - done > SIKTEC_EPD_IMAGE_BUFFER ? SIKTEC_EPD_IMAGE_BUFFER : run_len - done;
+                epd->readPlane(plane, offset + done, buffer, len);
+                if (invert) {
+                    for (uint16_t i = 0; i < len; i++) buffer[i] ^= invert;
+                }
+                if (out.write(buffer, len) != len) {
+                    return EPD_IMAGE_STATUS::IMAGE_ERROR_WRITE_FILE;
+                }
+                done += len;
+            }
+        }
+    }
+    return EPD_IMAGE_STATUS::IMAGE_DONE;
+}
+
+/**
+ * @brief loads an .epd image into the framebuffer at the raw region it was saved from.
+ * the image must be saved from a board with the same raw framebuffer size.
+ * a color plane is skipped on boards without one - a missing color plane leaves the
+ * color framebuffer untouched.
+ *
+ * @param epd   the SIKTEC_EPD to write the framebuffer of.
+ * @param in    an open FatFile of the .epd image.
+ * @return EPD_IMAGE_STATUS
+ */
+EPD_IMAGE_STATUS SIKTEC_EPD_IMAGE::load(SIKTEC_EPD *epd, FatFile &in) {
+
+    epd_image_header_t header;
+    EPD_IMAGE_STATUS status = SIKTEC_EPD_IMAGE::readHeader(in, header);
+    if (status != EPD_IMAGE_STATUS::IMAGE_DONE) {
+        return status;
+    }
+    if (header.panel_width != epd->rawWidth() || header.panel_height != epd->rawHeight()) {
+        return EPD_IMAGE_STATUS::IMAGE_PANEL_MISMATCH;
+    }
+    if ((uint32_t)header.x + header.columns > epd->rawWidth()
+        || (uint32_t)header.y + header.column_bytes * 8 > epd->rawHeight()
+        || (header.y & 0x7)
+    ) {
+        return EPD_IMAGE_STATUS::IMAGE_OUT_OF_BOUNDS;
+    }
+
+    uint32_t run_len;
+    uint16_t runs;
+    SIKTEC_EPD_IMAGE::planeRuns(epd, header, run_len, runs);
+
+    uint32_t first = epd->getRawColumnOffset(header.x + header.columns - 1, header.y);
+    uint32_t step  = epd->rawHeight() / 8;
+    uint8_t  buffer[SIKTEC_EPD_IMAGE_BUFFER];
+
+    for (uint8_t p = 0; p < 2; p++) {
+        epd_plane_t plane = p ? EPD_PLANE_COLOR : EPD_PLANE_BLACK;
+        if (!(header.planes & (p ? EPD_IMAGE_PLANE_COLOR : EPD_IMAGE_PLANE_BLACK))) {
+            continue;
+        }
+        if (!epd->planeSize(plane)) {
+            in.seekCur(header.plane_size);
+            continue;
+        }
+        uint8_t invert = epd->isPlaneInverted(plane) ? 0xFF : 0x00;
+        for (uint16_t r = 0; r < runs; r++) {
+            uint32_t offset = first + r * step;
+            for (uint32_t done = 0; done < run_len; ) {
+                uint16_t len = run_len - done > SIKTEC_EPD_IMAGE_BUFFER ? SIKTEC_EPD_IMAGE_BUFFER : run_len - done;
+                if (in.read(buffer, len) != len) {
+                    return EPD_IMAGE_STATUS::IMAGE_ERROR_READ_FILE;
+                }
+                if (invert) {
+                    for (uint16_t i = 0; i < len; i++) buffer[i] ^= invert;
+                }
+                epd->writePlane(plane, offset + done, buffer, len);
+                done += len;
+            }
+        }
+    }
+    return EPD_IMAGE_STATUS::IMAGE_DONE;
+}
+
+/**
+ * @brief streams a full screen .epd image from the SD directly to the EPD RAM and 
+ * refreshes the screen - the framebuffer is not used (or touched).
+ * the image must cover the whole raw framebuffer - saved with the full screen region.
+ *
+ * @param epd   the SIKTEC_EPD to display on.
+ * @param in    an open FatFile of the .epd image.
+ * @param sleep powerdown the display when done.
+ * @return EPD_IMAGE_STATUS
+ */
+EPD_IMAGE_STATUS SIKTEC_EPD_IMAGE::display(SIKTEC_EPD *epd, FatFile &in, bool sleep) {
+
+    epd_image_header_t header;
+    EPD_IMAGE_STATUS status = SIKTEC_EPD_IMAGE::readHeader(in, header);
+    if (status != EPD_IMAGE_STATUS::IMAGE_DONE) {
+        return status;
+    }
+    if (header.panel_width != epd->rawWidth() || header.panel_height != epd->rawHeight()) {
+        return EPD_IMAGE_STATUS::IMAGE_PANEL_MISMATCH;
+    }
+    if (header.x || header.y 
+        || header.columns != epd->rawWidth() 
+        || (uint32_t)header.column_bytes * 8 != epd->rawHeight()
+        || !(header.planes & EPD_IMAGE_PLANE_BLACK)
+    ) {
+        return EPD_IMAGE_STATUS::IMAGE_OUT_OF_BOUNDS;
+    }
+    //The planes follow the header:
+    if (!epd->displayFromFile(in, header.planes & EPD_IMAGE_PLANE_COLOR, sleep)) {
+        return EPD_IMAGE_STATUS::IMAGE_ERROR_READ_FILE;
+    }
+    return EPD_IMAGE_STATUS::IMAGE_DONE;
+}
+
+}
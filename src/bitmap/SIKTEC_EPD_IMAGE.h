@@ -0,0 +1,108 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Native pre-packed ".epd" images:
+ *  A small header followed by the black and color planes of a framebuffer
+ *  region - stored in the raw (unrotated) column-major layout of SIKTEC_EPD.
+ *  Loading an image is a sequential SD read copied straight into the
+ *  framebuffer (RAM or SRAM) - no decoding, filtering or pixel packing.
+ * File layout:
+ *  1. epd_image_header_t (24 bytes, little endian).
+ *  2. black plane - plane_size bytes (if EPD_IMAGE_PLANE_BLACK).
+ *  3. color plane - plane_size bytes (if EPD_IMAGE_PLANE_COLOR).
+ *  Each plane holds the region columns from the right most raw column
+ *  (lowest framebuffer offset) - column_bytes bytes per column, top to bottom.
+ *  Plane bits are stored normalized - 1 is ink, the board inversion is applied
+ *  on load.
+*******************************************************************************/
+/*****************************      Changelog       ****************************
+1.0.6:
+    -> initial release.
+    -> Save a framebuffer region / load it back with bulk transfers.
+    -> Full screen images are streamed directly to the EPD.
+*******************************************************************************/
+
+/**  @file SIKTEC_EPD_IMAGE.h */
+#pragma once
+
+/**********************************************************************************************/
+// LIB INCLUDES:
+/**********************************************************************************************/
+#include <Arduino.h>
+#include <SdFat.h>
+#include <SIKTEC_EPD.h>
+
+#ifndef SIKTEC_EPD_IMAGE_BUFFER
+    #define SIKTEC_EPD_IMAGE_BUFFER 64 // bytes moved per SD / framebuffer transfer while loading or saving
+#endif
+
+#define EPD_IMAGE_TYPE      0x4945 // 0x4945 ASCII 'EI' the .epd signature.
+#define EPD_IMAGE_VERSION   1
+
+#define EPD_IMAGE_PLANE_BLACK 0x01
+#define EPD_IMAGE_PLANE_COLOR 0x02
+
+namespace SIKtec {
+
+/**
+ * @brief IMAGE status flag returned from the load / save methods.
+ */
+enum EPD_IMAGE_STATUS {
+    IMAGE_DONE,
+    IMAGE_ERROR_READ_FILE,
+    IMAGE_ERROR_WRITE_FILE,
+    IMAGE_UNSUPPORTED_TYPE,
+    IMAGE_PANEL_MISMATCH,
+    IMAGE_OUT_OF_BOUNDS
+};
+
+/**
+ * @brief The .epd file header.
+ */
+typedef struct EPDImageHeader {
+    uint16_t type           = EPD_IMAGE_TYPE;
+    uint8_t  version        = EPD_IMAGE_VERSION;
+    uint8_t  planes         = 0;    // EPD_IMAGE_PLANE_BLACK | EPD_IMAGE_PLANE_COLOR
+    uint16_t panel_width    = 0;    // raw framebuffer width the image was saved from
+    uint16_t panel_height   = 0;    // raw framebuffer height the image was saved from
+    uint16_t x              = 0;    // raw region left column
+    uint16_t y              = 0;    // raw region top row - aligned to 8
+    uint16_t columns        = 0;    // raw region width
+    uint16_t column_bytes   = 0;    // raw region height / 8
+    uint8_t  rotation       = 0;    // the screen rotation when saved - informative
+    uint8_t  reserved       = 0;
+    uint16_t reserved2      = 0;
+    uint32_t plane_size     = 0;    // columns * column_bytes
+} epd_image_header_t;
+
+/**
+ * @brief Saves and loads framebuffer regions as .epd images.
+ */
+class SIKTEC_EPD_IMAGE {
+
+public:
+
+    /** @brief reads and validates the .epd header */
+    static EPD_IMAGE_STATUS readHeader(FatFile &file, epd_image_header_t &header);
+
+    /** @brief saves a screen region of the framebuffer as an .epd image */
+    static EPD_IMAGE_STATUS save(SIKTEC_EPD *epd, FatFile &out, int16_t x, int16_t y, int16_t w, int16_t h);
+
+    /** @brief loads an .epd image into the framebuffer at the region it was saved from */
+    static EPD_IMAGE_STATUS load(SIKTEC_EPD *epd, FatFile &in);
+
+    /** @brief streams a full screen .epd image directly to the EPD and refreshes - no framebuffer */
+    static EPD_IMAGE_STATUS display(SIKTEC_EPD *epd, FatFile &in, bool sleep = false);
+
+private:
+
+    /** @brief the plane byte runs of a region - a single run when the region spans full columns */
+    static void planeRuns(SIKTEC_EPD *epd, const epd_image_header_t &header, uint32_t &run_len, uint16_t &runs);
+
+};
+
+}
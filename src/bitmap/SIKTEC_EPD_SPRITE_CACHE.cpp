@@ -0,0 +1,442 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+
+/**  @file SIKTEC_EPD_SPRITE_CACHE.cpp */
+
+#include "SIKTEC_EPD_SPRITE_CACHE.h"
+
+namespace SIKtec {
+
+/**
+ * @brief Construct a new sprite cache.
+ * SRAM boards reserve the spare SRAM after the framebuffers (pool_bytes limits it - 0 for all of it),
+ * RAM boards allocate a pool of pool_bytes - 0 disables the cache.
+ * NOTE: the SRAM pool is reserved (reserveSramSpace) - the dither error rows and color LUTs 
+ * created later use the remaining space. Reservations are stacked - destroy in the reverse order.
+ *
+ * @param epd           the SIKTEC_EPD to blit to.
+ * @param pool_bytes    the pool size in bytes.
+ */
+SIKTEC_EPD_SPRITE_CACHE::SIKTEC_EPD_SPRITE_CACHE(SIKTEC_EPD *epd, uint32_t pool_bytes) {
+    this->epd = epd;
+    if (epd->is_using_sram()) {
+        epd_sram_space_t space = epd->getFreeSramSpace();
+        //The free space starts one byte after buffer2 and the reservation keeps one more:
+        uint32_t bytes = space.bytes > 2 ? space.bytes - 2 : 0;
+        this->pool_size = pool_bytes && pool_bytes < bytes ? pool_bytes : bytes;
+        this->sram_addr = epd->reserveSramSpace(this->pool_size);
+        if (this->sram_addr == 0) {
+            this->pool_size = 0;
+        }
+    } else if (pool_bytes) {
+        this->pool = new uint8_t[pool_bytes];
+        this->pool_size = this->pool != nullptr ? pool_bytes : 0;
+    }
+}
+
+/**
+ * @brief Destroy the sprite cache - releases the RAM pool or the SRAM reservation.
+ */
+SIKTEC_EPD_SPRITE_CACHE::~SIKTEC_EPD_SPRITE_CACHE() {
+    delete[] this->pool;
+    if (this->pool == nullptr && this->pool_size) {
+        this->epd->releaseSramSpace(this->pool_size);
+    }
+}
+
+/**
+ * @brief the pool size in bytes.
+ *
+ * @return uint32_t 0 when caching is not available.
+ */
+uint32_t SIKTEC_EPD_SPRITE_CACHE::capacity() {
+    return this->pool_size;
+}
+
+/**
+ * @brief the epd the sprites are decoded for and blitted to.
+ *
+ * @return SIKTEC_EPD*
+ */
+SIKTEC_EPD *SIKTEC_EPD_SPRITE_CACHE::target() {
+    return this->epd;
+}
+
+/**
+ * @brief whether two keys are of the same source file.
+ */
+static inline bool sameSource(const epd_sprite_key_t &a, const epd_sprite_key_t &b) {
+    return a.source == b.source && a.size == b.size && a.modified == b.modified;
+}
+
+/**
+ * @brief whether two keys are of the same decoded sprite.
+ */
+static inline bool sameSprite(const epd_sprite_key_t &a, const epd_sprite_key_t &b) {
+    return sameSource(a, b) && a.filter == b.filter && a.index == b.index;
+}
+
+/**
+ * @brief the raw layout of a sprite in the current rotation.
+ *
+ * @param width         sprite screen width.
+ * @param height        sprite screen height.
+ * @param columns       raw columns.
+ * @param column_bytes  raw column bytes.
+ * @return void
+ */
+void SIKTEC_EPD_SPRITE_CACHE::layout(uint16_t width, uint16_t height, uint16_t &columns, uint16_t &column_bytes) {
+    bool swapped = this->epd->getRotation() & 0x1;
+    columns      = swapped ? height : width;
+    column_bytes = ((swapped ? width : height) + 7) / 8;
+}
+
+/**
+ * @brief the bytes required to cache a sprite of the given screen size -
+ * the buffer size expected by plot and store.
+ *
+ * @param width     sprite screen width.
+ * @param height    sprite screen height.
+ * @return uint32_t
+ */
+uint32_t SIKTEC_EPD_SPRITE_CACHE::entrySize(uint16_t width, uint16_t height) {
+    uint16_t columns, column_bytes;
+    this->layout(width, height, columns, column_bytes);
+    uint8_t planes = this->epd->planeSize(EPD_PLANE_COLOR) ? 2 : 1;
+    return (uint32_t)columns * column_bytes * planes;
+}
+
+/**
+ * @brief finds a cached sprite decoded in the current rotation - counts a hit or a miss.
+ * the size is compared too - the same index of a redefined sprite grid is another sprite.
+ *
+ * @param key       the sprite source, filter and index.
+ * @param width     sprite screen width.
+ * @param height    sprite screen height.
+ * @return int16_t the slot or -1 when not cached.
+ */
+int16_t SIKTEC_EPD_SPRITE_CACHE::find(const epd_sprite_key_t &key, uint16_t width, uint16_t height) {
+    uint8_t rotation = this->epd->getRotation();
+    for (int16_t i = 0; i < SIKTEC_EPD_SPRITE_CACHE_SLOTS; ++i) {
+        epd_sprite_cache_entry_t &entry = this->entries[i];
+        if (entry.used && sameSprite(entry.key, key) && entry.rotation == rotation 
+            && entry.width == width && entry.height == height) {
+            entry.last_used = ++this->tick;
+            ++this->hits;
+            return i;
+        }
+    }
+    ++this->misses;
+    return -1;
+}
+
+/**
+ * @brief sets the layers of a pixel in decoded planes (entrySize bytes, zeroed).
+ *
+ * @param planes    the decoded planes buffer.
+ * @param width     sprite screen width.
+ * @param height    sprite screen height.
+ * @param x         local screen x.
+ * @param y         local screen y.
+ * @param layers    the pixel layers - see SIKTEC_EPD::colorLayers.
+ * @return void
+ */
+void SIKTEC_EPD_SPRITE_CACHE::plot(uint8_t *planes, uint16_t width, uint16_t height, uint16_t x, uint16_t y, uint8_t layers) {
+    if (!layers) {
+        return;
+    }
+    uint16_t columns, column_bytes;
+    this->layout(width, height, columns, column_bytes);
+    //Local raw coordinates - relative to the top-left raw corner of the sprite:
+    uint16_t lx, ly;
+    switch (this->epd->getRotation()) {
+        case 1:  lx = height - 1 - y; ly = x;              break;
+        case 2:  lx = width - 1 - x;  ly = height - 1 - y; break;
+        case 3:  lx = y;              ly = width - 1 - x;  break;
+        default: lx = x;              ly = y;
+    }
+    uint32_t byte = (uint32_t)lx * column_bytes + ly / 8;
+    uint8_t  bit  = 0x80 >> (ly & 0x7);
+    if (layers & 0x1) {
+        planes[byte] |= bit;
+    }
+    if ((layers & 0x2) && this->epd->planeSize(EPD_PLANE_COLOR)) {
+        planes[(uint32_t)columns * column_bytes + byte] |= bit;
+    }
+}
+
+/**
+ * @brief stores decoded planes - evicts the least recently used sprites until it fits.
+ * a previous entry of the same key (any rotation) is replaced.
+ *
+ * @param key       the sprite source, filter and index.
+ * @param width     sprite screen width.
+ * @param height    sprite screen height.
+ * @param planes    the decoded planes - entrySize bytes.
+ * @return int16_t the slot or -1 if the sprite is larger than the pool.
+ */
+int16_t SIKTEC_EPD_SPRITE_CACHE::store(const epd_sprite_key_t &key, uint16_t width, uint16_t height, const uint8_t *planes) {
+    uint32_t size = this->entrySize(width, height);
+    if (!size || size > this->pool_size) {
+        return -1;
+    }
+    //Replace the same key:
+    int16_t slot = -1;
+    for (int16_t i = 0; i < SIKTEC_EPD_SPRITE_CACHE_SLOTS; ++i) {
+        epd_sprite_cache_entry_t &entry = this->entries[i];
+        if (entry.used && sameSprite(entry.key, key)) {
+            entry = epd_sprite_cache_entry_t();
+        }
+        if (slot < 0 && !entry.used) {
+            slot = i;
+        }
+    }
+    //Make room:
+    uint32_t offset;
+    while (slot < 0 || !this->allocate(size, offset)) {
+        int16_t victim = this->leastUsed();
+        if (victim < 0) {
+            return -1;
+        }
+        this->entries[victim] = epd_sprite_cache_entry_t();
+        ++this->evictions;
+        if (slot < 0) {
+            slot = victim;
+        }
+    }
+    for (uint32_t done = 0; done < size; ) {
+        uint16_t len = size - done > 0xFFFF ? 0xFFFF : size - done;
+        this->poolWrite(offset + done, planes + done, len);
+        done += len;
+    }
+    epd_sprite_cache_entry_t &entry = this->entries[slot];
+    entry.used      = true;
+    entry.key       = key;
+    entry.rotation  = this->epd->getRotation();
+    entry.color     = this->epd->planeSize(EPD_PLANE_COLOR) > 0;
+    entry.width     = width;
+    entry.height    = height;
+    this->layout(width, height, entry.columns, entry.column_bytes);
+    entry.offset    = offset;
+    entry.size      = size;
+    entry.last_used = ++this->tick;
+    return slot;
+}
+
+/**
+ * @brief draws a cached sprite to the framebuffer - clipped to the screen.
+ * every raw column is merged with a single plane read and write (per plane), the
+ * read is skipped when the column covers whole bytes.
+ *
+ * @param slot  the slot returned by find / store.
+ * @param x     the top-left screen x.
+ * @param y     the top-left screen y.
+ * @return bool false if the slot is not valid.
+ */
+bool SIKTEC_EPD_SPRITE_CACHE::blit(int16_t slot, int16_t x, int16_t y) {
+    if (slot < 0 || slot >= SIKTEC_EPD_SPRITE_CACHE_SLOTS || !this->entries[slot].used) {
+        return false;
+    }
+    const epd_sprite_cache_entry_t &entry = this->entries[slot];
+    //Clip to screen:
+    int16_t x1 = x < 0 ? 0 : x;
+    int16_t y1 = y < 0 ? 0 : y;
+    int16_t x2 = x + entry.width  > this->epd->width()  ? this->epd->width()  : x + entry.width;
+    int16_t y2 = y + entry.height > this->epd->height() ? this->epd->height() : y + entry.height;
+    if (x1 >= x2 || y1 >= y2) {
+        return true;
+    }
+    //The raw origin of the sprite and the clipped raw region:
+    int16_t ox, oy, ax, ay, rx1, ry1, rx2, ry2;
+    this->epd->screenToRaw(x, y, ox, oy);
+    this->epd->screenToRaw(x + entry.width - 1, y + entry.height - 1, ax, ay);
+    if (ax < ox) ox = ax;
+    if (ay < oy) oy = ay;
+    this->epd->screenToRaw(x1, y1, rx1, ry1);
+    this->epd->screenToRaw(x2 - 1, y2 - 1, rx2, ry2);
+    if (rx1 > rx2) EPD_swap(rx1, rx2);
+    if (ry1 > ry2) EPD_swap(ry1, ry2);
+
+    uint16_t b1     = ry1 >> 3;
+    uint16_t len    = (ry2 >> 3) - b1 + 1;
+    uint8_t  first  = 0xFF >> (ry1 & 0x7);
+    uint8_t  last   = 0xFF << (7 - (ry2 & 0x7));
+    bool     merge  = first != 0xFF || last != 0xFF;
+    uint8_t  *src   = new uint8_t[entry.column_bytes];
+    uint8_t  *dst   = new uint8_t[len];
+    if (src == nullptr || dst == nullptr) {
+        delete[] src;
+        delete[] dst;
+        return false;
+    }
+
+    uint32_t plane_bytes = (uint32_t)entry.columns * entry.column_bytes;
+    for (uint8_t p = 0; p < 2; p++) {
+        epd_plane_t plane = p ? EPD_PLANE_COLOR : EPD_PLANE_BLACK;
+        if ((p && !entry.color) || !this->epd->planeSize(plane)) {
+            continue;
+        }
+        uint8_t invert = this->epd->isPlaneInverted(plane) ? 0xFF : 0x00;
+        for (int16_t rx = rx1; rx <= rx2; ++rx) {
+            this->poolRead(entry.offset + p * plane_bytes + (uint32_t)(rx - ox) * entry.column_bytes, src, entry.column_bytes);
+            uint32_t offset = this->epd->getRawColumnOffset(rx, b1 << 3);
+            if (merge) {
+                this->epd->readPlane(plane, offset, dst, len);
+            }
+            for (uint16_t i = 0; i < len; ++i) {
+                //The 8 sprite bits of this framebuffer byte - the bit offset may be negative (up to -7):
+                int16_t  s  = (int16_t)((b1 + i) << 3) - oy;
+                int16_t  q  = s < 0 ? -1 : s >> 3;
+                uint8_t  hi = q >= 0 && q < (int16_t)entry.column_bytes ? src[q] : 0;
+                uint8_t  lo = q + 1 < (int16_t)entry.column_bytes ? src[q + 1] : 0;
+                uint8_t  value = (uint8_t)((((uint16_t)hi << 8 | lo) << (s - q * 8)) >> 8) ^ invert;
+                uint8_t  mask  = (i == 0 ? first : 0xFF) & (i == len - 1 ? last : 0xFF);
+                dst[i] = (dst[i] & ~mask) | (value & mask);
+            }
+            this->epd->writePlane(plane, offset, dst, len);
+        }
+    }
+    delete[] src;
+    delete[] dst;
+    return true;
+}
+
+/**
+ * @brief removes all the sprites of a source file (any filter and index).
+ *
+ * @param key the source key - see SIKTEC_EPD_BITMAP::spriteKey.
+ * @return void
+ */
+void SIKTEC_EPD_SPRITE_CACHE::invalidate(const epd_sprite_key_t &key) {
+    for (uint8_t i = 0; i < SIKTEC_EPD_SPRITE_CACHE_SLOTS; ++i) {
+        if (this->entries[i].used && sameSource(this->entries[i].key, key)) {
+            this->entries[i] = epd_sprite_cache_entry_t();
+        }
+    }
+}
+
+/**
+ * @brief removes all the sprites.
+ *
+ * @return void
+ */
+void SIKTEC_EPD_SPRITE_CACHE::clear() {
+    for (uint8_t i = 0; i < SIKTEC_EPD_SPRITE_CACHE_SLOTS; ++i) {
+        this->entries[i] = epd_sprite_cache_entry_t();
+    }
+}
+
+/**
+ * @brief the cache statistics.
+ *
+ * @return epd_sprite_cache_stats_t
+ */
+epd_sprite_cache_stats_t SIKTEC_EPD_SPRITE_CACHE::stats() {
+    epd_sprite_cache_stats_t stats;
+    stats.hits      = this->hits;
+    stats.misses    = this->misses;
+    stats.evictions = this->evictions;
+    stats.capacity  = this->pool_size;
+    for (uint8_t i = 0; i < SIKTEC_EPD_SPRITE_CACHE_SLOTS; ++i) {
+        if (this->entries[i].used) {
+            stats.used += this->entries[i].size;
+            ++stats.entries;
+        }
+    }
+    return stats;
+}
+
+/**
+ * @brief resets the hit / miss / eviction counters.
+ *
+ * @return void
+ */
+void SIKTEC_EPD_SPRITE_CACHE::resetStats() {
+    this->hits      = 0;
+    this->misses    = 0;
+    this->evictions = 0;
+}
+
+/**
+ * @brief finds a free pool range - the lowest offset that fits (first fit).
+ *
+ * @param size      bytes required.
+ * @param offset    the pool offset found.
+ * @return bool false if no range fits.
+ */
+bool SIKTEC_EPD_SPRITE_CACHE::allocate(uint32_t size, uint32_t &offset) {
+    bool found = false;
+    //Candidates are the pool start and the end of every entry:
+    for (int16_t c = -1; c < SIKTEC_EPD_SPRITE_CACHE_SLOTS; ++c) {
+        if (c >= 0 && !this->entries[c].used) {
+            continue;
+        }
+        uint32_t start = c < 0 ? 0 : this->entries[c].offset + this->entries[c].size;
+        if (start + size > this->pool_size || (found && start >= offset)) {
+            continue;
+        }
+        bool overlaps = false;
+        for (uint8_t i = 0; i < SIKTEC_EPD_SPRITE_CACHE_SLOTS && !overlaps; ++i) {
+            const epd_sprite_cache_entry_t &entry = this->entries[i];
+            overlaps = entry.used && start < entry.offset + entry.size && entry.offset < start + size;
+        }
+        if (!overlaps) {
+            offset = start;
+            found  = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief the least recently used slot.
+ *
+ * @return int16_t -1 if the cache is empty.
+ */
+int16_t SIKTEC_EPD_SPRITE_CACHE::leastUsed() {
+    int16_t victim = -1;
+    for (int16_t i = 0; i < SIKTEC_EPD_SPRITE_CACHE_SLOTS; ++i) {
+        if (this->entries[i].used && (victim < 0 || this->entries[i].last_used < this->entries[victim].last_used)) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+/**
+ * @brief reads from the pool - a single SRAM transaction or a RAM copy.
+ *
+ * @param offset    pool offset.
+ * @param out       the buffer to read into.
+ * @param len       number of bytes.
+ * @return void
+ */
+void SIKTEC_EPD_SPRITE_CACHE::poolRead(uint32_t offset, uint8_t *out, uint16_t len) {
+    if (this->pool != nullptr) {
+        memcpy(out, this->pool + offset, len);
+    } else {
+        this->epd->sram->read(this->sram_addr + offset, out, len);
+    }
+}
+
+/**
+ * @brief writes to the pool - a single SRAM transaction or a RAM copy.
+ *
+ * @param offset    pool offset.
+ * @param in        the buffer to write from.
+ * @param len       number of bytes.
+ * @return void
+ */
+void SIKTEC_EPD_SPRITE_CACHE::poolWrite(uint32_t offset, const uint8_t *in, uint16_t len) {
+    if (this->pool != nullptr) {
+        memcpy(this->pool + offset, in, len);
+    } else {
+        this->epd->sram->write(this->sram_addr + offset, (uint8_t *)in, len);
+    }
+}
+
+}
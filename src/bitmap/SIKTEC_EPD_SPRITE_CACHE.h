@@ -0,0 +1,163 @@
+/******************************************************************************/
+// Created by: SIKTEC.
+// Release Version : 1.0.6
+// Creation Date: 2022-04-12
+// Copyright 2022, SIKTEC.
+/******************************************************************************/
+/*****************************      NOTES       *******************************
+ * Decoded sprites cache:
+ *  Sprites are decoded and filtered once into packed black / color bitplanes
+ *  kept in a pool - the spare SRAM after the framebuffers, reserved (SRAM boards) or a
+ *  RAM buffer. A cached sprite is drawn with byte level blits into the
+ *  framebuffer - one read and one write per raw column, any y alignment.
+ * Entry layout:
+ *  The planes are stored in the raw (unrotated) layout of the rotation they
+ *  were decoded with - columns of column_bytes bytes, MSB is the top pixel.
+ *  Plane bits are normalized - 1 is ink, the board inversion is applied on blit.
+ *  A rotation change is a miss (the rotation is part of the key).
+ * Keys:
+ *  the source file identity (name hash, size, last write stamp), filter, sprite 
+ *  index and size - a re-created bitmap of the same file hits, a changed file misses.
+ *  Filters are keyed by address - clear the cache when a cached filter changes.
+*******************************************************************************/
+/*****************************      Changelog       ****************************
+1.0.6:
+    -> initial release.
+    -> SRAM / RAM pool, LRU eviction and hit statistics.
+    -> Entries are keyed by the source file identity (not the bitmap instance).
+*******************************************************************************/
+
+/**  @file SIKTEC_EPD_SPRITE_CACHE.h */
+#pragma once
+
+/**********************************************************************************************/
+// LIB INCLUDES:
+/**********************************************************************************************/
+#include <Arduino.h>
+
+namespace SIKtec {
+
+/**
+ * @brief A cached sprite key - defined before the EPD headers (SIKTEC_EPD_BITMAP uses it).
+ */
+typedef struct EPDSpriteKey {
+    uint32_t    source          = 0;        // the source file name hash
+    uint32_t    size            = 0;        // the source file size
+    uint32_t    modified        = 0;        // the source file last write stamp
+    const void  *filter         = nullptr;  // the filter the sprite is decoded with
+    uint16_t    index           = 0;        // the sprite index
+} epd_sprite_key_t;
+
+}
+
+#include <SIKTEC_EPD.h>
+
+#ifndef SIKTEC_EPD_SPRITE_CACHE_SLOTS
+    #define SIKTEC_EPD_SPRITE_CACHE_SLOTS 16 // max number of sprites kept in the cache
+#endif
+
+namespace SIKtec {
+
+/**
+ * @brief A cached sprite - the planes location in the pool and the key.
+ */
+typedef struct EPDSpriteCacheEntry {
+    bool        used            = false;    // false when the slot is free
+    epd_sprite_key_t key;                   // the source, filter and sprite index
+    uint8_t     rotation        = 0;        // the screen rotation when decoded
+    bool        color           = false;    // has a color plane
+    uint16_t    width           = 0;        // sprite screen width
+    uint16_t    height          = 0;        // sprite screen height
+    uint16_t    columns         = 0;        // raw columns
+    uint16_t    column_bytes    = 0;        // raw column bytes
+    uint32_t    offset          = 0;        // pool offset of the black plane - the color plane follows
+    uint32_t    size            = 0;        // total bytes of the planes
+    uint32_t    last_used       = 0;        // LRU tick
+} epd_sprite_cache_entry_t;
+
+/**
+ * @brief The sprite cache statistics.
+ */
+typedef struct EPDSpriteCacheStats {
+    uint32_t    hits        = 0;
+    uint32_t    misses      = 0;
+    uint32_t    evictions   = 0;
+    uint32_t    capacity    = 0;    // pool size in bytes
+    uint32_t    used        = 0;    // bytes used by the cached sprites
+    uint8_t     entries     = 0;    // cached sprites
+} epd_sprite_cache_stats_t;
+
+/**
+ * @brief Keeps decoded sprites as packed bitplanes and blits them to the framebuffer.
+ */
+class SIKTEC_EPD_SPRITE_CACHE {
+
+public:
+
+    /** @brief Construct a new sprite cache - SRAM pool on SRAM boards, RAM pool otherwise */
+    SIKTEC_EPD_SPRITE_CACHE(SIKTEC_EPD *epd, uint32_t pool_bytes = 0);
+
+    /** @brief Destroy the sprite cache - releases the RAM pool or the SRAM reservation */
+    ~SIKTEC_EPD_SPRITE_CACHE();
+
+    /** @brief the pool size in bytes - 0 when caching is not available */
+    uint32_t capacity();
+
+    /** @brief the bytes required to cache a sprite of the given screen size */
+    uint32_t entrySize(uint16_t width, uint16_t height);
+
+    /** @brief the epd the sprites are decoded for and blitted to */
+    SIKTEC_EPD *target();
+
+    /** @brief finds a cached sprite - counts a hit or a miss */
+    int16_t find(const epd_sprite_key_t &key, uint16_t width, uint16_t height);
+
+    /** @brief sets a pixel of decoded planes - local screen coordinates */
+    void plot(uint8_t *planes, uint16_t width, uint16_t height, uint16_t x, uint16_t y, uint8_t layers);
+
+    /** @brief stores decoded planes - evicts the least recently used sprites when required */
+    int16_t store(const epd_sprite_key_t &key, uint16_t width, uint16_t height, const uint8_t *planes);
+
+    /** @brief draws a cached sprite to the framebuffer */
+    bool blit(int16_t slot, int16_t x, int16_t y);
+
+    /** @brief removes all the sprites of a source file */
+    void invalidate(const epd_sprite_key_t &key);
+
+    /** @brief removes all the sprites */
+    void clear();
+
+    /** @brief the cache statistics */
+    epd_sprite_cache_stats_t stats();
+
+    /** @brief resets the hit / miss / eviction counters */
+    void resetStats();
+
+private:
+
+    SIKTEC_EPD  *epd;
+    uint8_t     *pool       = nullptr;  // RAM pool - nullptr when using SRAM
+    uint16_t    sram_addr   = 0;        // SRAM pool address
+    uint32_t    pool_size   = 0;
+    uint32_t    tick        = 0;
+    uint32_t    hits        = 0;
+    uint32_t    misses      = 0;
+    uint32_t    evictions   = 0;
+    epd_sprite_cache_entry_t entries[SIKTEC_EPD_SPRITE_CACHE_SLOTS];
+
+    /** @brief the raw layout of a sprite in the current rotation */
+    void layout(uint16_t width, uint16_t height, uint16_t &columns, uint16_t &column_bytes);
+
+    /** @brief finds a free pool range - first fit */
+    bool allocate(uint32_t size, uint32_t &offset);
+
+    /** @brief the least recently used slot */
+    int16_t leastUsed();
+
+    /** @brief pool transfers */
+    void poolRead(uint32_t offset, uint8_t *out, uint16_t len);
+    void poolWrite(uint32_t offset, const uint8_t *in, uint16_t len);
+
+};
+
+}